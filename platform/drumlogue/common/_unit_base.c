@@ -10,6 +10,12 @@
 
 #include "unit.h"
 
+#if defined(PROFILE_ENABLE)
+// Single definition of the profiling table shared by all unit sources
+#define PROFILE_IMPLEMENTATION
+#include "profile.h"
+#endif
+
 // ---- Fallback unit header definition  -----------------------------------------------------------
 
 // Fallback unit header, note that this content is invalid, must be overriden
@@ -104,3 +110,94 @@ __attribute__((weak)) void unit_aftertouch(uint8_t note, uint8_t mod) {
   (void)note;
   (void)mod;
 }
+
+// ---- Optional CPU load meter wrappers ----------------------------------------------------------
+
+#if defined(UNIT_CPU_METER)
+
+#include <stdio.h>
+#include <time.h>
+
+#undef unit_init
+#undef unit_render
+#undef unit_get_param_value
+#undef unit_get_param_str_value
+#undef unit_set_param_value
+
+static struct {
+  float ns_per_frame;  // render deadline per frame
+  float load;          // smoothed load
+  float peak;          // peak load since last reset
+  uint32_t xruns;      // renders that exceeded their deadline
+  char str[32];
+} s_cpu_meter;
+
+static inline uint64_t cpu_meter_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void cpu_meter_reset(void) {
+  s_cpu_meter.load = 0.f;
+  s_cpu_meter.peak = 0.f;
+  s_cpu_meter.xruns = 0;
+}
+
+__unit_callback int8_t unit_init(const unit_runtime_desc_t * desc) {
+  s_cpu_meter.ns_per_frame = (desc && desc->samplerate) ? 1e9f / desc->samplerate : 1e9f / 48000.f;
+  cpu_meter_reset();
+  return unit_metered_init(desc);
+}
+
+__unit_callback void unit_render(const float * in, float * out, uint32_t frames) {
+  const uint64_t start = cpu_meter_now_ns();
+  unit_metered_render(in, out, frames);
+  const float elapsed = (float)(cpu_meter_now_ns() - start);
+  if (!frames)
+    return;
+
+  // Load relative to the time it takes to play back the rendered frames
+  const float load = elapsed / (s_cpu_meter.ns_per_frame * frames);
+  s_cpu_meter.load += 0.05f * (load - s_cpu_meter.load);
+  if (load > s_cpu_meter.peak)
+    s_cpu_meter.peak = load;
+  if (load > 1.f)
+    s_cpu_meter.xruns++;
+}
+
+static int32_t cpu_meter_percent(float load) {
+  // Clamp before converting, also catches non finite values
+  if (!(load < 9.99f))
+    return 999;
+  return (int32_t)(100.f * load + 0.5f);
+}
+
+__unit_callback int32_t unit_get_param_value(uint8_t id) {
+  if (id == UNIT_CPU_METER_PARAM) {
+    const int32_t pct = cpu_meter_percent(s_cpu_meter.load);
+    return (pct > 100) ? 100 : pct;
+  }
+  return unit_metered_get_param_value(id);
+}
+
+__unit_callback const char * unit_get_param_str_value(uint8_t id, int32_t value) {
+  if (id == UNIT_CPU_METER_PARAM) {
+    snprintf(s_cpu_meter.str, sizeof(s_cpu_meter.str), "%d%% pk %d%% x%u",
+             (int)cpu_meter_percent(s_cpu_meter.load), (int)cpu_meter_percent(s_cpu_meter.peak),
+             (unsigned)s_cpu_meter.xruns);
+    return s_cpu_meter.str;
+  }
+  return unit_metered_get_param_str_value(id, value);
+}
+
+__unit_callback void unit_set_param_value(uint8_t id, int32_t value) {
+  // Turning the meter parameter resets peak and xrun count
+  if (id == UNIT_CPU_METER_PARAM) {
+    cpu_meter_reset();
+    return;
+  }
+  unit_metered_set_param_value(id, value);
+}
+
+#endif  // UNIT_CPU_METER
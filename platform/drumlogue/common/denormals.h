@@ -0,0 +1,249 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    denormals.h
+ * @brief   Floating point unit denormal handling.
+ *
+ * @addtogroup utils Utils
+ * @{
+ *
+ * @addtogroup utils_denormals Denormals
+ * @{
+ *
+ */
+
+#ifndef __denormals_h
+#define __denormals_h
+
+#include <stdint.h>
+
+#if !defined(__arm__) && (defined(__SSE__) || defined(__x86_64__))
+#include <xmmintrin.h>
+#endif
+
+/*===========================================================================*/
+/* Constants.                                                                */
+/*===========================================================================*/
+
+/**
+ * @name    FPU control and status bits
+ * @{
+ */
+
+#if defined(__arm__)
+/** FPSCR flush-to-zero mode */
+#define k_fpu_ftz_mask       (1U<<24)
+/** FPSCR input denormal cumulative flag, set when a denormal input was flushed */
+#define k_fpu_denormal_flag  (1U<<7)
+#elif defined(__SSE__) || defined(__x86_64__)
+/** MXCSR flush-to-zero and denormals-are-zero modes */
+#define k_fpu_ftz_mask       (0x8000U | 0x0040U)
+/** MXCSR denormal operand flag */
+#define k_fpu_denormal_flag  (0x0002U)
+#else
+#define k_fpu_ftz_mask       (0U)
+#define k_fpu_denormal_flag  (0U)
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/* Types.                                                                    */
+/*===========================================================================*/
+
+/**
+ * @name    Types
+ * @{
+ */
+
+/** Denormal occurrence statistics, see fpu_denormal_scope_end() */
+typedef struct {
+  uint32_t calls;  ///< Number of scopes ended
+  uint32_t hits;   ///< Number of scopes during which denormal operands were seen
+} fpu_denormal_stats_t;
+
+/** @} */
+
+/*===========================================================================*/
+/* FPU Control.                                                              */
+/*===========================================================================*/
+
+/**
+ * @name    FPU control
+ * @{
+ */
+
+/** Read FPU control and status register (FPSCR or MXCSR)
+ */
+static inline __attribute__((always_inline))
+uint32_t fpu_get_csr(void) {
+#if defined(__arm__)
+  uint32_t csr;
+  __asm__ volatile ("vmrs %0, fpscr" : "=r" (csr));
+  return csr;
+#elif defined(__SSE__) || defined(__x86_64__)
+  return _mm_getcsr();
+#else
+  return 0;
+#endif
+}
+
+/** Write FPU control and status register (FPSCR or MXCSR)
+ */
+static inline __attribute__((always_inline))
+void fpu_set_csr(uint32_t csr) {
+#if defined(__arm__)
+  __asm__ volatile ("vmsr fpscr, %0" : : "r" (csr) : "memory");
+#elif defined(__SSE__) || defined(__x86_64__)
+  _mm_setcsr(csr);
+#else
+  (void)csr;
+#endif
+}
+
+/** Enable flush-to-zero, returning previous register state for fpu_restore_csr()
+ */
+static inline __attribute__((always_inline))
+uint32_t fpu_ftz_enable(void) {
+  const uint32_t csr = fpu_get_csr();
+  fpu_set_csr(csr | k_fpu_ftz_mask);
+  return csr;
+}
+
+/** Restore flush-to-zero mode saved by fpu_ftz_enable()
+ */
+static inline __attribute__((always_inline))
+void fpu_ftz_restore(uint32_t saved) {
+  const uint32_t csr = fpu_get_csr();
+  fpu_set_csr((csr & ~k_fpu_ftz_mask) | (saved & k_fpu_ftz_mask));
+}
+
+/** Clear sticky denormal flag
+ */
+static inline __attribute__((always_inline))
+void fpu_denormal_flag_clear(void) {
+  fpu_set_csr(fpu_get_csr() & ~k_fpu_denormal_flag);
+}
+
+/** Check sticky denormal flag
+ */
+static inline __attribute__((always_inline))
+uint32_t fpu_denormal_flag(void) {
+  return fpu_get_csr() & k_fpu_denormal_flag;
+}
+
+/** @} */
+
+/*===========================================================================*/
+/* Render Callback Scopes.                                                   */
+/*===========================================================================*/
+
+/**
+ * @name    Render callback scopes
+ *
+ * Wrap render callbacks so that denormals are flushed to zero. When FPU_DENORMAL_COUNT
+ * is defined, e.g.: in host test harness builds, flush-to-zero is left disabled on x86
+ * so that the slow path is observable, and scopes during which denormal operands were
+ * seen are counted. On ARM, flush-to-zero stays enabled and flushed denormal inputs are
+ * counted instead.
+ * @{
+ */
+
+/** Begin a denormal safe scope, returning state for fpu_denormal_scope_end()
+ */
+static inline __attribute__((always_inline))
+uint32_t fpu_denormal_scope_begin(void) {
+#if defined(FPU_DENORMAL_COUNT)
+  fpu_denormal_flag_clear();
+#if defined(__arm__)
+  return fpu_ftz_enable();
+#else
+  return fpu_get_csr();
+#endif
+#else
+  return fpu_ftz_enable();
+#endif
+}
+
+/** End a denormal safe scope
+ *
+ * @param saved State returned by fpu_denormal_scope_begin()
+ * @param stats Statistics to update, only used when FPU_DENORMAL_COUNT is defined, can be NULL
+ */
+static inline __attribute__((always_inline))
+void fpu_denormal_scope_end(uint32_t saved, fpu_denormal_stats_t *stats) {
+#if defined(FPU_DENORMAL_COUNT)
+  if (stats) {
+    stats->calls++;
+    if (fpu_denormal_flag())
+      stats->hits++;
+  }
+#else
+  (void)stats;
+#endif
+  fpu_ftz_restore(saved);
+}
+
+#ifdef __cplusplus
+
+/**
+ * Scoped flush-to-zero mode for render callbacks
+ *
+ * @code
+ * void DELFX_PROCESS(float *xn, uint32_t frames) {
+ *   const FpuDenormalScope ftz;
+ *   ...
+ * }
+ * @endcode
+ */
+struct FpuDenormalScope {
+  FpuDenormalScope(fpu_denormal_stats_t *stats = 0) :
+    mSaved(fpu_denormal_scope_begin()), mStats(stats)
+  { }
+
+  ~FpuDenormalScope(void) {
+    fpu_denormal_scope_end(mSaved, mStats);
+  }
+
+  uint32_t mSaved;
+  fpu_denormal_stats_t *mStats;
+};
+
+#endif
+
+/** @} */
+
+#endif // __denormals_h
+
+/** @} @} */
@@ -14,6 +14,24 @@
 #include "attributes.h"
 #include "runtime.h"
 
+// ---- Optional CPU load meter -------------------------------------------------------------------
+//
+// Define UNIT_CPU_METER and UNIT_CPU_METER_PARAM=<param index> (e.g.: via UDEFS in config.mk) to
+// measure unit_render() against its deadline and display load on the given parameter slot, which
+// should be declared as a k_unit_param_type_strings parameter with range 0-100 in header.c.
+// The unit's own callbacks are renamed and wrapped by the implementations in _unit_base.c.
+
+#if defined(UNIT_CPU_METER)
+#ifndef UNIT_CPU_METER_PARAM
+#error "UNIT_CPU_METER requires UNIT_CPU_METER_PARAM to be defined to a parameter index"
+#endif
+#define unit_init unit_metered_init
+#define unit_render unit_metered_render
+#define unit_get_param_value unit_metered_get_param_value
+#define unit_get_param_str_value unit_metered_get_param_str_value
+#define unit_set_param_value unit_metered_set_param_value
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
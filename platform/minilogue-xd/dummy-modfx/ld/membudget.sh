@@ -0,0 +1,208 @@
+#!/bin/bash
+#
+# BSD 3-Clause License
+#
+# Copyright (c) 2018, KORG INC.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# * Redistributions of source code must retain the above copyright notice, this
+#   list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above copyright notice,
+#   this list of conditions and the following disclaimer in the documentation
+#   and/or other materials provided with the distribution.
+#
+# * Neither the name of the copyright holder nor the names of its
+#   contributors may be used to endorse or promote products derived from
+#   this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#
+# membudget.sh <elf> <ldscript> <objdump> [REGION=SIZE ...]
+#
+# Breaks down the memory usage of a linked unit per output section and per
+# symbol, and checks it against the MEMORY regions declared in the linker
+# script. Optional REGION=SIZE arguments (e.g. SRAM=24K) tighten the budget of
+# a region below its linker script length. Exits with a non-zero status if any
+# region exceeds its budget.
+#
+# Environment:
+#   MEMBUDGET_TOP : number of symbols listed per section (default: 10)
+#
+
+ELF="$1"
+LDSCRIPT="$2"
+OD="$3"
+shift 3
+
+MEMBUDGET_TOP=${MEMBUDGET_TOP:-10}
+
+if [[ ! -f "${ELF}" ]] || [[ ! -f "${LDSCRIPT}" ]] || [[ -z "${OD}" ]]; then
+    echo "usage: $(basename $0) <elf> <ldscript> <objdump> [REGION=SIZE ...]" 1>&2
+    exit 2
+fi
+
+set -o pipefail
+
+AWK=$(which awk) || { echo "Error: dependency not found..." 1>&2; exit 2; }
+
+{
+    echo "@budgets $*"
+    echo "@ldscript"
+    cat "${LDSCRIPT}"
+    echo "@sections"
+    "${OD}" -h "${ELF}" || exit 2
+    echo "@symbols"
+    "${OD}" -t -C "${ELF}" || exit 2
+} | ${AWK} -v elf="${ELF}" -v top="${MEMBUDGET_TOP}" '
+
+function hex2dec(h,    i, c, v) {
+    h = tolower(h)
+    sub(/^0x/, "", h)
+    v = 0
+    for (i = 1; i <= length(h); i++) {
+        c = index("0123456789abcdef", substr(h, i, 1))
+        if (c == 0)
+            break
+        v = v * 16 + c - 1
+    }
+    return v
+}
+
+function size2dec(s,    m) {
+    m = 1
+    if (s ~ /[kK]$/) m = 1024
+    else if (s ~ /[mM]$/) m = 1024 * 1024
+    sub(/[kKmM]$/, "", s)
+    return ((s ~ /^0[xX]/) ? hex2dec(s) : s + 0) * m
+}
+
+function region_of(addr,    r) {
+    for (r = 0; r < nregions; r++)
+        if (addr >= rorg[r] && addr < rorg[r] + rlen[r])
+            return r
+    return -1
+}
+
+BEGIN { nregions = 0; nsections = 0 }
+
+/^@budgets/  { for (i = 2; i <= NF; i++) { split($i, kv, "="); budget[kv[1]] = size2dec(kv[2]) } next }
+/^@ldscript/ { mode = "ld"; next }
+/^@sections/ { mode = "sec"; next }
+/^@symbols/  { mode = "sym"; next }
+
+mode == "ld" {
+    if ($0 ~ /^[ \t]*MEMORY/) inmem = 1
+    else if (inmem && $0 ~ /}/) inmem = 0
+    else if (inmem && $0 ~ /org[ \t]*=/) {
+        line = $0
+        name = line; sub(/^[ \t]*/, "", name); sub(/[ \t(:].*$/, "", name)
+        org = line; sub(/^.*org[ \t]*=[ \t]*/, "", org); sub(/[ \t,].*$/, "", org)
+        len = line; sub(/^.*len[ \t]*=[ \t]*/, "", len); sub(/[ \t,].*$/, "", len)
+        rname[nregions] = name
+        rorg_str[nregions] = org
+        rorg[nregions] = hex2dec(org)
+        rlen[nregions] = size2dec(len)
+        nregions++
+    }
+    next
+}
+
+mode == "sec" {
+    if ($1 ~ /^[0-9]+$/ && NF >= 6) {
+        pname = $2; psize = hex2dec($3); pvma = hex2dec($4)
+        next
+    }
+    if (pname != "" && $0 ~ /ALLOC/) {
+        r = region_of(pvma)
+        sname[nsections] = pname
+        ssize[nsections] = psize
+        sregion[nsections] = r
+        if (r >= 0) rused[r] += psize
+        nsections++
+    }
+    pname = ""
+    next
+}
+
+mode == "sym" {
+    # objdump -t: "<addr> <flags> <section>\t<size> <name>"
+    n = index($0, "\t")
+    if (n == 0) next
+    split(substr($0, 1, n - 1), head, " ")
+    sec = head[length(head)]
+    if (sec !~ /^\.(text|rodata|data|bss|sdram)$/) next
+    tail = substr($0, n + 1)
+    size = hex2dec(substr(tail, 1, index(tail, " ") - 1))
+    if (size == 0) next
+    sym = substr(tail, index(tail, " ") + 1)
+    sub(/^[ \t]*/, "", sym)
+    if (sym == "") next
+    k = nsyms[sec]++
+    symname[sec, k] = sym
+    symsize[sec, k] = size
+    next
+}
+
+END {
+    printf("Memory budget for %s\n\n", elf)
+
+    printf("  %-16s %-8s %10s\n", "Section", "Region", "Size")
+    for (s = 0; s < nsections; s++)
+        printf("  %-16s %-8s %10d\n", sname[s], (sregion[s] >= 0) ? rname[sregion[s]] : "-", ssize[s])
+    printf("\n")
+
+    split(".text .rodata .data .bss .sdram", order, " ")
+    for (o = 1; o <= 5; o++) {
+        sec = order[o]
+        cnt = nsyms[sec] + 0
+        if (cnt == 0 || top <= 0) continue
+        # Selection sort of the largest entries only, symbol tables are short.
+        printf("  Largest symbols in %s\n", sec)
+        for (i = 0; i < cnt && i < top; i++) {
+            m = i
+            for (j = i + 1; j < cnt; j++)
+                if (symsize[sec, j] > symsize[sec, m]) m = j
+            t = symname[sec, i]; symname[sec, i] = symname[sec, m]; symname[sec, m] = t
+            t = symsize[sec, i]; symsize[sec, i] = symsize[sec, m]; symsize[sec, m] = t
+            printf("    %10d  %s\n", symsize[sec, i], symname[sec, i])
+        }
+        printf("\n")
+    }
+
+    status = 0
+    printf("  %-8s %-12s %10s %10s %10s %10s\n", "Region", "Origin", "Used", "Budget", "Headroom", "Usage")
+    for (r = 0; r < nregions; r++) {
+        b = (rname[r] in budget) ? budget[rname[r]] : rlen[r]
+        if (b > rlen[r]) b = rlen[r]
+        u = rused[r] + 0
+        printf("  %-8s %-12s %10d %10d %10d %9.1f%%\n", rname[r], rorg_str[r], u, b, b - u, (b > 0) ? 100.0 * u / b : 0)
+        if (u > b) {
+            printf("Error: %s over budget by %d bytes\n", rname[r], u - b) > "/dev/stderr"
+            status = 1
+        }
+    }
+    for (k in budget) {
+        found = 0
+        for (r = 0; r < nregions; r++)
+            if (rname[r] == k) found = 1
+        if (!found)
+            printf("Warning: budget given for unknown region %s\n", k) > "/dev/stderr"
+    }
+    printf("\n")
+    exit status
+}
+'
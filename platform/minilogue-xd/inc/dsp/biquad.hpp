@@ -399,6 +399,34 @@ namespace dsp {
     float process(const float xn) {
       return process_so(xn);
     }
+
+    /**
+     * Second order processing of one sample, keeping states out of denormal range
+     *
+     * @param xn  Input sample
+     *
+     * @return Output sample
+     *
+     * @note Adds a tiny DC offset to the input, for feedback paths that may decay for long periods.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process_so_safe(const float xn) {
+      return process_so(xn + k_f32_anti_denormal);
+    }
+
+    /**
+     * First order processing of one sample, keeping states out of denormal range
+     *
+     * @param xn  Input sample
+     *
+     * @return Output sample
+     *
+     * @note Adds a tiny DC offset to the input, for feedback paths that may decay for long periods.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process_fo_safe(const float xn) {
+      return process_fo(xn + k_f32_anti_denormal);
+    }
       
     /*=====================================================================*/
     /* Member Variables.                                                   */
@@ -409,6 +437,117 @@ namespace dsp {
     float mZ1, mZ2;      
   };
 
+  /**
+   * Transposed form 2 Bi-Quad construct processing two channels with shared coefficients.
+   *
+   * Lanes are typically main and sub timbres, or left and right channels. The primary lane
+   * can also be processed alone, leaving the secondary lane state untouched.
+   */
+  struct PairBiQuad {
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Default constructor
+     */
+    PairBiQuad(void)
+    {
+      flush();
+    }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Flush internal delays
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void flush(void) {
+      mZ1 = mZ2 = f32pair(0.f, 0.f);
+    }
+
+    /**
+     * Flush internal delays of secondary lane
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void flush_b(void) {
+      mZ1.b = mZ2.b = 0.f;
+    }
+
+    /**
+     * Second order processing of one sample pair
+     *
+     * @param xn  Input sample pair
+     *
+     * @return Output sample pair
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    f32pair_t process_so(const f32pair_t xn) {
+      const BiQuad::Coeffs &c = mCoeffs;
+      const f32pair_t acc = f32pair_add(f32pair_mulscal(xn, c.ff0), mZ1);
+      mZ1 = f32pair_sub(f32pair_add(f32pair_mulscal(xn, c.ff1), mZ2), f32pair_mulscal(acc, c.fb1));
+      mZ2 = f32pair_sub(f32pair_mulscal(xn, c.ff2), f32pair_mulscal(acc, c.fb2));
+      return acc;
+    }
+
+    /**
+     * First order processing of one sample pair
+     *
+     * @param xn  Input sample pair
+     *
+     * @return Output sample pair
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    f32pair_t process_fo(const f32pair_t xn) {
+      const BiQuad::Coeffs &c = mCoeffs;
+      const f32pair_t acc = f32pair_add(f32pair_mulscal(xn, c.ff0), mZ1);
+      mZ1 = f32pair_sub(f32pair_mulscal(xn, c.ff1), f32pair_mulscal(acc, c.fb1));
+      return acc;
+    }
+
+    /**
+     * Second order processing of one sample of the primary lane only
+     *
+     * @param xn  Input sample
+     *
+     * @return Output sample
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process_so_a(const float xn) {
+      const BiQuad::Coeffs &c = mCoeffs;
+      const float acc = c.ff0 * xn + mZ1.a;
+      mZ1.a = c.ff1 * xn + mZ2.a - c.fb1 * acc;
+      mZ2.a = c.ff2 * xn - c.fb2 * acc;
+      return acc;
+    }
+
+    /**
+     * First order processing of one sample of the primary lane only
+     *
+     * @param xn  Input sample
+     *
+     * @return Output sample
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process_fo_a(const float xn) {
+      const BiQuad::Coeffs &c = mCoeffs;
+      const float acc = c.ff0 * xn + mZ1.a;
+      mZ1.a = c.ff1 * xn - c.fb1 * acc;
+      return acc;
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    /** Coefficients shared by both lanes */
+    BiQuad::Coeffs mCoeffs;
+    f32pair_t mZ1, mZ2;
+  };
+
   /**
    * Extended transposed form 2 Bi-Quad construct
    */
@@ -0,0 +1,194 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    chorus_bench.hpp
+ * @brief   Cost comparison of Chorus against a naive per timbre tap build.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ * Timing relies on profile.h, so define PROFILE_ENABLE to get cycle counts on target
+ * (DWT) or nanoseconds on host, otherwise only the output difference is measured.
+ *
+ * Typical use from a modfx build, e.g.: reporting ticks via a parameter or debugger:
+ * @code
+ * static __sdram dsp::DelayStorageF32::pair_t s_bench_ram[2 * 2048];
+ * static float s_bench_buf[8 * 64];
+ * static dsp::ChorusBenchResult s_bench;
+ *
+ * void MODFX_INIT(uint32_t platform, uint32_t api) {
+ *   profile_init();
+ *   dsp::benchChorus<4>(s_bench_ram, 2048, s_bench_buf, 64, 256, &s_bench);
+ * }
+ * @endcode
+ */
+
+#include "profile.h"
+#include "chorus.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Chorus with the same signal flow as Chorus, but reading each timbre of each voice
+   * with read0Frac() / read1Frac(), i.e.: one address computation and two loads per
+   * timbre instead of one address computation and two pair loads per voice.
+   */
+  template <uint32_t V, typename Storage = DelayStorageF32>
+  struct NaiveChorus : public Chorus<V, Storage> {
+
+    typedef Chorus<V, Storage> Base;
+
+    /**
+     * Process main and sub timbre interleaved stereo buffers, see Chorus::process()
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float * main_xn, float * main_yn,
+                 const float * sub_xn, float * sub_yn,
+                 const uint32_t frames) {
+      this->mLfo.setF0(this->mRate * frames, this->mFsRecip);
+      this->mLfo.cycle();
+
+      const float frames_recip = 1.f / frames;
+      float delay[V];
+      float delay_inc[V];
+      for (uint32_t v = 0; v < V; ++v) {
+        const float target = this->mCenter + this->mDepth * this->mLfo.sine_bi_off((float)v / V);
+        delay[v] = this->mDelay[v];
+        delay_inc[v] = (target - delay[v]) * frames_recip;
+        this->mDelay[v] = target;
+      }
+
+      const float dry = this->mDry;
+      const float wet = this->mWet;
+
+      const float * xn_e = main_xn + 2 * frames;
+      for (; main_xn != xn_e; main_xn += 2, sub_xn += 2, main_yn += 2, sub_yn += 2) {
+        const float main_l = main_xn[0], main_r = main_xn[1];
+        const float sub_l = sub_xn[0], sub_r = sub_xn[1];
+
+        this->mLine.write(f32pair(this->mPreFilter[0].process_so(0.5f * (main_l + main_r)),
+                                  this->mPreFilter[1].process_so(0.5f * (sub_l + sub_r))));
+
+        f32pair_t wet_main = f32pair(0.f, 0.f);
+        f32pair_t wet_sub = f32pair(0.f, 0.f);
+        for (uint32_t v = 0; v < V; ++v) {
+          const float d = (delay[v] += delay_inc[v]);
+          const f32pair_t g = this->mGain[v];
+          wet_main = f32pair_add(wet_main, f32pair_mulscal(g, this->mLine.read0Frac(d)));
+          wet_sub = f32pair_add(wet_sub, f32pair_mulscal(g, this->mLine.read1Frac(d)));
+        }
+
+        main_yn[0] = dry * main_l + wet * this->mPostFilter[0].process_fo(wet_main.a);
+        main_yn[1] = dry * main_r + wet * this->mPostFilter[1].process_fo(wet_main.b);
+        sub_yn[0] = dry * sub_l + wet * this->mPostFilter[2].process_fo(wet_sub.a);
+        sub_yn[1] = dry * sub_r + wet * this->mPostFilter[3].process_fo(wet_sub.b);
+      }
+    }
+  };
+
+  /**
+   * Results of benchChorus()
+   */
+  typedef struct ChorusBenchResult {
+    float ticks;        /**< Average ticks per frame of Chorus, 0 unless PROFILE_ENABLE is defined */
+    float naive_ticks;  /**< Average ticks per frame of NaiveChorus, 0 unless PROFILE_ENABLE is defined */
+    float max_diff;     /**< Maximum absolute difference between outputs */
+  } ChorusBenchResult;
+
+  /**
+   * Run Chorus and NaiveChorus side by side on the same noise input
+   *
+   * @param ram Delay memory of 2 * line_size sample pairs, split between both engines
+   * @param line_size Size in sample pairs of each delay line, power of two
+   * @param buf Work buffer of 8 * frames floats
+   * @param frames Block size in frames
+   * @param blocks Number of blocks to process
+   * @param res Results
+   */
+  template <uint32_t V, typename Storage>
+  inline void benchChorus(typename Storage::pair_t *ram, size_t line_size, float *buf,
+                          const uint32_t frames, const uint32_t blocks, ChorusBenchResult *res) {
+    Chorus<V, Storage> chorus;
+    NaiveChorus<V, Storage> naive;
+    chorus.init(ram, line_size, 48000.f);
+    naive.init(ram + line_size, line_size, 48000.f);
+    chorus.setRate(0.8f);
+    naive.setRate(0.8f);
+
+    float * const main = buf;
+    float * const sub = buf + 2 * frames;
+    float * const naive_main = buf + 4 * frames;
+    float * const naive_sub = buf + 6 * frames;
+
+    uint32_t rand = 0x2545F491;
+    uint64_t ticks = 0;
+    uint64_t naive_ticks = 0;
+    float max_diff = 0.f;
+    for (uint32_t b = 0; b < blocks; ++b) {
+      // Main and sub buffers are contiguous, as are their naive copies
+      for (uint32_t i = 0; i < 4 * frames; ++i) {
+        // xorshift32 noise
+        rand ^= rand << 13;
+        rand ^= rand >> 17;
+        rand ^= rand << 5;
+        main[i] = naive_main[i] = q31_to_f32((q31_t)rand);
+      }
+#if defined(PROFILE_ENABLE)
+      uint32_t t0 = profile_now();
+      chorus.process(main, main, sub, sub, frames);
+      ticks += profile_now() - t0;
+      t0 = profile_now();
+      naive.process(naive_main, naive_main, naive_sub, naive_sub, frames);
+      naive_ticks += profile_now() - t0;
+#else
+      chorus.process(main, main, sub, sub, frames);
+      naive.process(naive_main, naive_main, naive_sub, naive_sub, frames);
+#endif
+      for (uint32_t i = 0; i < 4 * frames; ++i) {
+        const float d = si_fabsf(main[i] - naive_main[i]);
+        if (d > max_diff)
+          max_diff = d;
+      }
+    }
+    res->ticks = (float)ticks / (blocks * frames);
+    res->naive_ticks = (float)naive_ticks / (blocks * frames);
+    res->max_diff = max_diff;
+  }
+}
+
+/** @} */
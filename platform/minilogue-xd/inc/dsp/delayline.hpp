@@ -43,6 +43,7 @@
 
 #include "float_math.h"
 #include "int_math.h"
+#include "fixed_math.h"
 #include "buffer_ops.h"
 
 /**
@@ -50,14 +51,95 @@
  */
 namespace dsp {
 
+  /**
+   * Delay line storage as 32-bit float (default).
+   */
+  struct DelayStorageF32 {
+    typedef float sample_t;
+    typedef f32pair_t pair_t;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(sample_t &dst, const float x) { dst = x; }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float load(const sample_t &src) { return src; }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(pair_t &dst, const f32pair_t &p) { dst = p; }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    f32pair_t load(const pair_t &src) { return src; }
+  };
+
+  /**
+   * Delay line storage as q15, saturating on write. Halves memory usage.
+   */
+  struct DelayStorageQ15 {
+    typedef q15_t sample_t;
+    typedef struct pair {
+      q15_t a;
+      q15_t b;
+    } pair_t;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(sample_t &dst, const float x) { dst = f32_to_q15(x); }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float load(const sample_t &src) { return q15_to_f32(src); }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(pair_t &dst, const f32pair_t &p) {
+      dst.a = f32_to_q15(p.a);
+      dst.b = f32_to_q15(p.b);
+    }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    f32pair_t load(const pair_t &src) { return f32pair(q15_to_f32(src.a), q15_to_f32(src.b)); }
+  };
+
+#if defined(__ARM_FP16_FORMAT_IEEE) || defined(__ARM_FP16_FORMAT_ALTERNATIVE)
+  /**
+   * Delay line storage as 16-bit float. Halves memory usage.
+   *
+   * @note Only available when building with -mfp16-format, conversions use the FPU's vcvtb/vcvtt.
+   */
+  struct DelayStorageF16 {
+    typedef __fp16 sample_t;
+    typedef struct pair {
+      __fp16 a;
+      __fp16 b;
+    } pair_t;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(sample_t &dst, const float x) { dst = x; }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float load(const sample_t &src) { return src; }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(pair_t &dst, const f32pair_t &p) {
+      dst.a = p.a;
+      dst.b = p.b;
+    }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    f32pair_t load(const pair_t &src) { return f32pair(src.a, src.b); }
+  };
+#endif
+
   /**
    * Basic delay line abstraction.
+   *
+   * @tparam Storage Sample storage format, e.g.: DelayStorageF32, DelayStorageQ15
    */
-  struct DelayLine {
+  template <typename Storage>
+  struct BasicDelayLine {
       
     /*===========================================================================*/
     /* Types and Data Structures.                                                */
     /*===========================================================================*/
+
+    typedef typename Storage::sample_t sample_t;
       
     /*===========================================================================*/
     /* Constructor / Destructor.                                                 */
@@ -66,7 +148,7 @@ namespace dsp {
     /**
      * Default constructor
      */
-    DelayLine(void) :
+    BasicDelayLine(void) :
       mLine(0),
       mFracZ(0),
       mSize(0),
@@ -78,10 +160,10 @@ namespace dsp {
      * Constructor with explicit memory area to use as backing buffer for delay line.
      *
      * @param ram Pointer to memory buffer
-     * @param line_size Size in float of memory buffer
+     * @param line_size Size in samples of memory buffer
      *
      */
-    DelayLine(float *ram, size_t line_size) :
+    BasicDelayLine(sample_t *ram, size_t line_size) :
       mLine(ram),
       mFracZ(0),
       mSize(line_size),
@@ -98,19 +180,19 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     void clear(void) {
-      buf_clr_f32((float *)mLine, mSize);
+      buf_clr_u32((uint32_t *)mLine, (mSize * sizeof(sample_t) + 3) >> 2);
     }
 
     /**
      * Set the memory area to use as backing buffer for the delay line.
      *
      * @param ram Pointer to memory buffer
-     * @param line_size Size in float of memory buffer
+     * @param line_size Size in samples of memory buffer
      *
      * @note Will round size to next power of two.
      */
     inline __attribute__((optimize("Ofast"),always_inline))
-    void setMemory(float *ram, size_t line_size) {
+    void setMemory(sample_t *ram, size_t line_size) {
       mLine = ram;
       mSize = nextpow2_u32(line_size); // must be power of 2
       mMask = (mSize-1);
@@ -124,7 +206,35 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     void write(const float s) {
-      mLine[(mWriteIdx--) & mMask] = s;
+      Storage::store(mLine[(mWriteIdx--) & mMask], s);
+    }
+
+    /**
+     * Write a single sample to the head of the delay line, flushing denormals to zero
+     *
+     * @param s Sample to write, typically a decaying feedback signal
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void writeSafe(const float s) {
+      write(si_flush_denormf(s));
+    }
+
+    /**
+     * Write a block of samples to the head of the delay line, oldest first
+     *
+     * @param xn Input buffer
+     * @param frames Number of samples to write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void write(const float * __restrict xn, const uint32_t frames) {
+      sample_t * __restrict line = mLine;
+      const size_t mask = mMask;
+      uint32_t idx = mWriteIdx;
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        Storage::store(line[(idx--) & mask], *(xn++));
+      }
+      mWriteIdx = idx;
     }
 
     /**
@@ -135,7 +245,28 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     float read(const uint32_t pos) {
-      return mLine[(mWriteIdx + pos) & mMask];
+      return Storage::load(mLine[(mWriteIdx + pos) & mMask]);
+    }
+
+    /**
+     * Read a block of samples following a block write.
+     *
+     * Equivalent to interleaving write(x) and read(pos) for each sample of the block last
+     * written with write(const float *, uint32_t).
+     *
+     * @param pos Offset from write index, at least 1
+     * @param yn Output buffer
+     * @param frames Number of samples to read, same as last block write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void read(const uint32_t pos, float * __restrict yn, const uint32_t frames) {
+      const sample_t * __restrict line = mLine;
+      const size_t mask = mMask;
+      uint32_t idx = mWriteIdx + frames - 1 + pos;
+      const float * yn_e = yn + frames;
+      for (; yn != yn_e; ) {
+        *(yn++) = Storage::load(line[(idx--) & mask]);
+      }
     }
 
     /**
@@ -173,22 +304,38 @@ namespace dsp {
     /* Member Variables.                                                         */
     /*===========================================================================*/
       
-    float   *mLine;
-    float    mFracZ;
-    size_t   mSize;
-    size_t   mMask;
-    uint32_t mWriteIdx;
+    sample_t *mLine;
+    float     mFracZ;
+    size_t    mSize;
+    size_t    mMask;
+    uint32_t  mWriteIdx;
       
   };
 
+  /** Delay line with float storage */
+  typedef BasicDelayLine<DelayStorageF32> DelayLine;
+
+  /** Delay line with q15 storage */
+  typedef BasicDelayLine<DelayStorageQ15> DelayLineQ15;
+
+#if defined(__ARM_FP16_FORMAT_IEEE) || defined(__ARM_FP16_FORMAT_ALTERNATIVE)
+  /** Delay line with 16-bit float storage */
+  typedef BasicDelayLine<DelayStorageF16> DelayLineF16;
+#endif
+
   /**
    * Dual channel delay line abstraction with interleaved samples. 
+   *
+   * @tparam Storage Sample storage format, e.g.: DelayStorageF32, DelayStorageQ15
    */
-  struct DualDelayLine {
+  template <typename Storage>
+  struct BasicDualDelayLine {
       
     /*===========================================================================*/
     /* Types and Data Structures.                                                */
     /*===========================================================================*/
+
+    typedef typename Storage::pair_t pair_t;
       
     /*===========================================================================*/
     /* Constructor / Destructor.                                                 */
@@ -197,7 +344,7 @@ namespace dsp {
     /**
      * Default constructor.
      */
-    DualDelayLine(void) :
+    BasicDualDelayLine(void) :
       mLine(0),
       mSize(0),
       mMask(0),
@@ -209,10 +356,10 @@ namespace dsp {
      * Constructor with explicit memory area to use as backing buffer for delay line.
      *
      * @param ram Pointer to memory buffer
-     * @param line_size Size in float pairs of memory buffer
+     * @param line_size Size in sample pairs of memory buffer
      *
      */
-    DualDelayLine(f32pair_t *ram, size_t line_size) :
+    BasicDualDelayLine(pair_t *ram, size_t line_size) :
       mWriteIdx(0)
     {
       setMemory(ram, line_size);
@@ -227,19 +374,19 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     void clear(void) {
-      buf_clr_f32((float *)mLine, 2*mSize);
+      buf_clr_u32((uint32_t *)mLine, (mSize * sizeof(pair_t) + 3) >> 2);
     }
 
     /**
      * Set the memory area to use as backing buffer for the delay line.
      *
      * @param ram Pointer to memory buffer
-     * @param line_size Size in float pairs of memory buffer
+     * @param line_size Size in sample pairs of memory buffer
      *
      * @note Will round size to next power of two.
      */
     inline __attribute__((optimize("Ofast"),always_inline))
-    void setMemory(f32pair_t *ram, size_t line_size) {
+    void setMemory(pair_t *ram, size_t line_size) {
       mLine = ram;
       mSize = nextpow2_u32(line_size); // must be power of 2
       mMask = (mSize-1);
@@ -253,7 +400,35 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     void write(const f32pair_t &p) {
-      mLine[(mWriteIdx--) & mMask] = p;
+      Storage::store(mLine[(mWriteIdx--) & mMask], p);
+    }
+
+    /**
+     * Write a sample pair to the delay line, flushing denormals to zero
+     *
+     * @param p Reference to float pair, typically a decaying feedback signal
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void writeSafe(const f32pair_t &p) {
+      write(f32pair(si_flush_denormf(p.a), si_flush_denormf(p.b)));
+    }
+
+    /**
+     * Write a block of sample pairs to the delay line, oldest first
+     *
+     * @param xn Input buffer
+     * @param frames Number of sample pairs to write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void write(const f32pair_t * __restrict xn, const uint32_t frames) {
+      pair_t * __restrict line = mLine;
+      const size_t mask = mMask;
+      uint32_t idx = mWriteIdx;
+      const f32pair_t * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        Storage::store(line[(idx--) & mask], *(xn++));
+      }
+      mWriteIdx = idx;
     }
 
     /**
@@ -264,7 +439,28 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     f32pair_t read(const uint32_t pos) {
-      return mLine[(mWriteIdx + pos) & mMask];
+      return Storage::load(mLine[(mWriteIdx + pos) & mMask]);
+    }
+
+    /**
+     * Read a block of sample pairs following a block write.
+     *
+     * Equivalent to interleaving write(p) and read(pos) for each sample pair of the block last
+     * written with write(const f32pair_t *, uint32_t).
+     *
+     * @param pos Offset from write index, at least 1
+     * @param yn Output buffer
+     * @param frames Number of sample pairs to read, same as last block write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void read(const uint32_t pos, f32pair_t * __restrict yn, const uint32_t frames) {
+      const pair_t * __restrict line = mLine;
+      const size_t mask = mMask;
+      uint32_t idx = mWriteIdx + frames - 1 + pos;
+      const f32pair_t * yn_e = yn + frames;
+      for (; yn != yn_e; ) {
+        *(yn++) = Storage::load(line[(idx--) & mask]);
+      }
     }
 
     /**
@@ -306,7 +502,7 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     float read0(const uint32_t pos) {
-      return (mLine[(mWriteIdx + pos) & mMask]).a;
+      return Storage::load((mLine[(mWriteIdx + pos) & mMask]).a);
     }
 
     /**
@@ -317,7 +513,7 @@ namespace dsp {
      */
     inline __attribute__((optimize("Ofast"),always_inline))
     float read1(const uint32_t pos) {
-      return (mLine[(mWriteIdx + pos) & mMask]).b;
+      return Storage::load((mLine[(mWriteIdx + pos) & mMask]).b);
     }
 
     /**
@@ -384,13 +580,422 @@ namespace dsp {
     /* Member Variables.                                                         */
     /*===========================================================================*/
       
-    f32pair_t *mLine;
+    pair_t    *mLine;
     f32pair_t  mFracZ;
     size_t     mSize;
     size_t     mMask;
     uint32_t   mWriteIdx;
       
   };
+
+  /** Dual delay line with float storage */
+  typedef BasicDualDelayLine<DelayStorageF32> DualDelayLine;
+
+  /** Dual delay line with q15 storage */
+  typedef BasicDualDelayLine<DelayStorageQ15> DualDelayLineQ15;
+
+#if defined(__ARM_FP16_FORMAT_IEEE) || defined(__ARM_FP16_FORMAT_ALTERNATIVE)
+  /** Dual delay line with 16-bit float storage */
+  typedef BasicDualDelayLine<DelayStorageF16> DualDelayLineF16;
+#endif
+
+  /**
+   * Delay line of exact length.
+   *
+   * Unlike BasicDelayLine, memory size is not rounded to a power of two. Single sample
+   * accesses wrap with a compare instead of a mask, and block accesses are split into at
+   * most two contiguous segments so that inner loops have no wrap logic at all.
+   *
+   * @tparam Storage Sample storage format, e.g.: DelayStorageF32, DelayStorageQ15
+   */
+  template <typename Storage>
+  struct BasicExactDelayLine {
+      
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    typedef typename Storage::sample_t sample_t;
+    typedef float value_t;
+      
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    BasicExactDelayLine(void) :
+      mLine(0),
+      mSize(0),
+      mWriteIdx(0)
+    { }
+
+    /**
+     * Constructor with explicit memory area to use as backing buffer for delay line.
+     *
+     * @param ram Pointer to memory buffer
+     * @param line_size Size in samples of memory buffer, used as is
+     *
+     */
+    BasicExactDelayLine(sample_t *ram, size_t line_size) :
+      mLine(ram),
+      mSize(line_size),
+      mWriteIdx(0)
+    { }
+      
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Zero clear the whole delay line.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void clear(void) {
+      buf_clr_u32((uint32_t *)mLine, (mSize * sizeof(sample_t)) >> 2);
+      if ((mSize * sizeof(sample_t)) & 0x3)
+        Storage::store(mLine[mSize-1], value_t());
+    }
+
+    /**
+     * Set the memory area to use as backing buffer for the delay line.
+     *
+     * @param ram Pointer to memory buffer
+     * @param line_size Size in samples of memory buffer, used as is
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setMemory(sample_t *ram, size_t line_size) {
+      mLine = ram;
+      mSize = line_size;
+      mWriteIdx = 0;
+    }
+
+    /**
+     * Write a single sample to the head of the delay line
+     *
+     * @param s Sample to write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void write(const value_t &s) {
+      Storage::store(mLine[mWriteIdx], s);
+      mWriteIdx = (mWriteIdx ? mWriteIdx : mSize) - 1;
+    }
+
+    /**
+     * Write a single sample to the head of the delay line, flushing denormals to zero
+     *
+     * @param s Sample to write, typically a decaying feedback signal
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void writeSafe(const value_t &s) {
+      write(si_flush_denormf(s));
+    }
+
+    /**
+     * Write a block of samples to the head of the delay line, oldest first
+     *
+     * @param xn Input buffer
+     * @param frames Number of samples to write, at most line size
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void write(const value_t * __restrict xn, const uint32_t frames) {
+      sample_t * __restrict line = mLine;
+      uint32_t idx = mWriteIdx;
+      // First segment runs down to the start of the buffer at most
+      const uint32_t n0 = (frames <= idx + 1) ? frames : idx + 1;
+      sample_t *dst = line + idx;
+      const value_t * xn_e = xn + n0;
+      for (; xn != xn_e; ) {
+        Storage::store(*(dst--), *(xn++));
+      }
+      idx -= n0;
+      if (n0 < frames) {
+        // Second segment restarts from the end of the buffer
+        idx = mSize - 1 - (frames - n0);
+        dst = line + mSize - 1;
+        xn_e += frames - n0;
+        for (; xn != xn_e; ) {
+          Storage::store(*(dst--), *(xn++));
+        }
+      }
+      mWriteIdx = (idx < mSize) ? idx : mSize - 1;
+    }
+
+    /**
+     * Read a single sample from the delay line at given position from current write index.
+     *
+     * @param pos Offset from write index, less than line size
+     * @return Sample at given position from write index
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    value_t read(const uint32_t pos) {
+      uint32_t idx = mWriteIdx + pos;
+      if (idx >= mSize)
+        idx -= mSize;
+      return Storage::load(mLine[idx]);
+    }
+
+    /**
+     * Read a block of samples following a block write.
+     *
+     * Equivalent to interleaving write(x) and read(pos) for each sample of the block last
+     * written with the block version of write().
+     *
+     * @param pos Offset from write index, at least 1, and pos + frames at most line size
+     * @param yn Output buffer
+     * @param frames Number of samples to read, same as last block write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void read(const uint32_t pos, value_t * __restrict yn, const uint32_t frames) {
+      const sample_t * __restrict line = mLine;
+      uint32_t idx = mWriteIdx + frames - 1 + pos;
+      if (idx >= mSize)
+        idx -= mSize;
+      const uint32_t n0 = (frames <= idx + 1) ? frames : idx + 1;
+      const sample_t *src = line + idx;
+      const value_t * yn_e = yn + n0;
+      for (; yn != yn_e; ) {
+        *(yn++) = Storage::load(*(src--));
+      }
+      if (n0 < frames) {
+        src = line + mSize - 1;
+        yn_e += frames - n0;
+        for (; yn != yn_e; ) {
+          *(yn++) = Storage::load(*(src--));
+        }
+      }
+    }
+
+    /**
+     * Read a sample from the delay line at a fractional position from current write index.
+     *
+     * @param pos Offset from write index as floating point, less than line size - 1
+     * @return Interpolated sample at given fractional position from write index
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    value_t readFrac(const float pos) {
+      const uint32_t base = (uint32_t)pos;
+      const float frac = pos - base;
+      const value_t s0 = read(base);
+      const value_t s1 = read(base+1);
+      return linintf(frac, s0, s1);
+    }
+      
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+      
+    sample_t *mLine;
+    size_t    mSize;
+    uint32_t  mWriteIdx;
+      
+  };
+
+  /** Exact length delay line with float storage */
+  typedef BasicExactDelayLine<DelayStorageF32> ExactDelayLine;
+
+  /** Exact length delay line with q15 storage */
+  typedef BasicExactDelayLine<DelayStorageQ15> ExactDelayLineQ15;
+
+  /**
+   * Dual channel delay line of exact length, with interleaved samples.
+   *
+   * Unlike BasicDualDelayLine, memory size is not rounded to a power of two. Single sample
+   * accesses wrap with a compare instead of a mask, and block accesses are split into at
+   * most two contiguous segments so that inner loops have no wrap logic at all.
+   *
+   * @tparam Storage Sample storage format, e.g.: DelayStorageF32, DelayStorageQ15
+   */
+  template <typename Storage>
+  struct BasicExactDualDelayLine {
+      
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    typedef typename Storage::pair_t pair_t;
+    typedef f32pair_t value_t;
+      
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    BasicExactDualDelayLine(void) :
+      mLine(0),
+      mSize(0),
+      mWriteIdx(0)
+    { }
+
+    /**
+     * Constructor with explicit memory area to use as backing buffer for delay line.
+     *
+     * @param ram Pointer to memory buffer
+     * @param line_size Size in sample pairs of memory buffer, used as is
+     *
+     */
+    BasicExactDualDelayLine(pair_t *ram, size_t line_size) :
+      mLine(ram),
+      mSize(line_size),
+      mWriteIdx(0)
+    { }
+      
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Zero clear the whole delay line.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void clear(void) {
+      buf_clr_u32((uint32_t *)mLine, (mSize * sizeof(pair_t)) >> 2);
+      if ((mSize * sizeof(pair_t)) & 0x3)
+        Storage::store(mLine[mSize-1], value_t());
+    }
+
+    /**
+     * Set the memory area to use as backing buffer for the delay line.
+     *
+     * @param ram Pointer to memory buffer
+     * @param line_size Size in sample pairs of memory buffer, used as is
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setMemory(pair_t *ram, size_t line_size) {
+      mLine = ram;
+      mSize = line_size;
+      mWriteIdx = 0;
+    }
+
+    /**
+     * Write a sample pair to the head of the delay line
+     *
+     * @param s Sample pair to write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void write(const value_t &s) {
+      Storage::store(mLine[mWriteIdx], s);
+      mWriteIdx = (mWriteIdx ? mWriteIdx : mSize) - 1;
+    }
+
+    /**
+     * Write a sample pair to the head of the delay line, flushing denormals to zero
+     *
+     * @param s Sample pair to write, typically a decaying feedback signal
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void writeSafe(const value_t &s) {
+      write(f32pair(si_flush_denormf(s.a), si_flush_denormf(s.b)));
+    }
+
+    /**
+     * Write a block of sample pairs to the head of the delay line, oldest first
+     *
+     * @param xn Input buffer
+     * @param frames Number of sample pairs to write, at most line size
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void write(const value_t * __restrict xn, const uint32_t frames) {
+      pair_t * __restrict line = mLine;
+      uint32_t idx = mWriteIdx;
+      // First segment runs down to the start of the buffer at most
+      const uint32_t n0 = (frames <= idx + 1) ? frames : idx + 1;
+      pair_t *dst = line + idx;
+      const value_t * xn_e = xn + n0;
+      for (; xn != xn_e; ) {
+        Storage::store(*(dst--), *(xn++));
+      }
+      idx -= n0;
+      if (n0 < frames) {
+        // Second segment restarts from the end of the buffer
+        idx = mSize - 1 - (frames - n0);
+        dst = line + mSize - 1;
+        xn_e += frames - n0;
+        for (; xn != xn_e; ) {
+          Storage::store(*(dst--), *(xn++));
+        }
+      }
+      mWriteIdx = (idx < mSize) ? idx : mSize - 1;
+    }
+
+    /**
+     * Read a sample pair from the delay line at given position from current write index.
+     *
+     * @param pos Offset from write index, less than line size
+     * @return Sample pair at given position from write index
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    value_t read(const uint32_t pos) {
+      uint32_t idx = mWriteIdx + pos;
+      if (idx >= mSize)
+        idx -= mSize;
+      return Storage::load(mLine[idx]);
+    }
+
+    /**
+     * Read a block of sample pairs following a block write.
+     *
+     * Equivalent to interleaving write(x) and read(pos) for each sample pair of the block last
+     * written with the block version of write().
+     *
+     * @param pos Offset from write index, at least 1, and pos + frames at most line size
+     * @param yn Output buffer
+     * @param frames Number of sample pairs to read, same as last block write
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void read(const uint32_t pos, value_t * __restrict yn, const uint32_t frames) {
+      const pair_t * __restrict line = mLine;
+      uint32_t idx = mWriteIdx + frames - 1 + pos;
+      if (idx >= mSize)
+        idx -= mSize;
+      const uint32_t n0 = (frames <= idx + 1) ? frames : idx + 1;
+      const pair_t *src = line + idx;
+      const value_t * yn_e = yn + n0;
+      for (; yn != yn_e; ) {
+        *(yn++) = Storage::load(*(src--));
+      }
+      if (n0 < frames) {
+        src = line + mSize - 1;
+        yn_e += frames - n0;
+        for (; yn != yn_e; ) {
+          *(yn++) = Storage::load(*(src--));
+        }
+      }
+    }
+
+    /**
+     * Read a sample pair from the delay line at a fractional position from current write index.
+     *
+     * @param pos Offset from write index as floating point, less than line size - 1
+     * @return Interpolated sample pair at given fractional position from write index
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    value_t readFrac(const float pos) {
+      const uint32_t base = (uint32_t)pos;
+      const float frac = pos - base;
+      const value_t s0 = read(base);
+      const value_t s1 = read(base+1);
+      return f32pair_linint(frac, s0, s1);
+    }
+      
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+      
+    pair_t *mLine;
+    size_t    mSize;
+    uint32_t  mWriteIdx;
+      
+  };
+
+  /** Exact length dual delay line with float storage */
+  typedef BasicExactDualDelayLine<DelayStorageF32> ExactDualDelayLine;
+
+  /** Exact length dual delay line with q15 storage */
+  typedef BasicExactDualDelayLine<DelayStorageQ15> ExactDualDelayLineQ15;
     
     
 }
@@ -0,0 +1,498 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    fm4.hpp
+ * @brief   Four operator phase modulation engine.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include "fixed_math.h"
+#include "float_math.h"
+#include "phasor.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Operator primitives shared by FM4 algorithms.
+   *
+   * Sines are looked up from a half period table, as used by osc_sinf(), directly
+   * from uq32 phases. Modulation is applied in the phase domain: modulator outputs
+   * are pre-scaled to cycles in q24 format, so that the conversion to a uq32 phase
+   * offset is a float to integer conversion and a shift, with wrap around implicit
+   * in the integer overflow.
+   *
+   * @tparam size_exp Half period table size as a power of two exponent
+   */
+  template <uint32_t size_exp>
+  struct FM4Op {
+
+    /**
+     * Sine of a uq32 phase
+     *
+     * @param lut Half period sine table with (1<<size_exp) entries plus guard point
+     * @param phi Phase in uq32 format
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float sine(const float *lut, const uq32_t phi)
+    {
+      const uint32_t x0p = phi >> (31 - size_exp);
+      const uint32_t x0 = x0p & ((1U<<size_exp)-1);
+      const float y = linintf(uq32_to_f32(phi << (size_exp + 1)), lut[x0], lut[x0+1]);
+      return (x0p >> size_exp) ? -y : y;
+    }
+
+    /**
+     * Phase offset for a modulation signal
+     *
+     * @param y Modulation in cycles, q24 format
+     * @return Phase offset in uq32 format
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    uq32_t pm(const float y)
+    {
+      return (uq32_t)(int32_t)y << 8;
+    }
+  };
+
+  /**
+   * FM4 operator graphs.
+   *
+   * Operators are numbered 0 to 3, operator 3 has self feedback. Each specialization
+   * evaluates one sample of its graph in dependency order without branching, given
+   * operator phases, gains (carriers scaled for output, modulators scaled to q24
+   * cycles) and the feedback phase offset. The sine of operator 3 is returned through
+   * s3 for the feedback path.
+   *
+   * | Alg. | Graph                  | Carriers   |
+   * |------|------------------------|------------|
+   * | 0    | 3 > 2 > 1 > 0          | 0          |
+   * | 1    | (2 + 3) > 1 > 0        | 0          |
+   * | 2    | (3 + (2 > 1)) > 0      | 0          |
+   * | 3    | ((3 > 2) + 1) > 0      | 0          |
+   * | 4    | 3 > 2, 1 > 0           | 0, 2       |
+   * | 5    | 3 > 0, 3 > 1, 3 > 2    | 0, 1, 2    |
+   * | 6    | 3 > 2, 1, 0            | 0, 1, 2    |
+   * | 7    | 3, 2, 1, 0             | 0, 1, 2, 3 |
+   */
+  template <uint32_t alg, uint32_t size_exp>
+  struct FM4Algorithm;
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<0, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0x1;
+    static const uint32_t k_carrier_count = 1;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      const float y2 = g[2] * Op::sine(lut, phi[2] + Op::pm(g[3] * s3));
+      const float y1 = g[1] * Op::sine(lut, phi[1] + Op::pm(y2));
+      return g[0] * Op::sine(lut, phi[0] + Op::pm(y1));
+    }
+  };
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<1, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0x1;
+    static const uint32_t k_carrier_count = 1;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      const float y2 = g[2] * Op::sine(lut, phi[2]);
+      const float y1 = g[1] * Op::sine(lut, phi[1] + Op::pm(y2 + g[3] * s3));
+      return g[0] * Op::sine(lut, phi[0] + Op::pm(y1));
+    }
+  };
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<2, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0x1;
+    static const uint32_t k_carrier_count = 1;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      const float y2 = g[2] * Op::sine(lut, phi[2]);
+      const float y1 = g[1] * Op::sine(lut, phi[1] + Op::pm(y2));
+      return g[0] * Op::sine(lut, phi[0] + Op::pm(y1 + g[3] * s3));
+    }
+  };
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<3, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0x1;
+    static const uint32_t k_carrier_count = 1;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      const float y2 = g[2] * Op::sine(lut, phi[2] + Op::pm(g[3] * s3));
+      const float y1 = g[1] * Op::sine(lut, phi[1]);
+      return g[0] * Op::sine(lut, phi[0] + Op::pm(y1 + y2));
+    }
+  };
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<4, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0x5;
+    static const uint32_t k_carrier_count = 2;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      const float y2 = g[2] * Op::sine(lut, phi[2] + Op::pm(g[3] * s3));
+      const float y1 = g[1] * Op::sine(lut, phi[1]);
+      return y2 + g[0] * Op::sine(lut, phi[0] + Op::pm(y1));
+    }
+  };
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<5, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0x7;
+    static const uint32_t k_carrier_count = 3;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      const uq32_t m = Op::pm(g[3] * s3);
+      return g[2] * Op::sine(lut, phi[2] + m)
+        + g[1] * Op::sine(lut, phi[1] + m)
+        + g[0] * Op::sine(lut, phi[0] + m);
+    }
+  };
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<6, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0x7;
+    static const uint32_t k_carrier_count = 3;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      return g[2] * Op::sine(lut, phi[2] + Op::pm(g[3] * s3))
+        + g[1] * Op::sine(lut, phi[1])
+        + g[0] * Op::sine(lut, phi[0]);
+    }
+  };
+
+  /** @private */
+  template <uint32_t size_exp>
+  struct FM4Algorithm<7, size_exp> : FM4Op<size_exp> {
+    static const uint32_t k_carriers = 0xF;
+    static const uint32_t k_carrier_count = 4;
+    typedef FM4Op<size_exp> Op;
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(const float *lut, const uq32_t *phi, const float *g, const uq32_t fb, float &s3)
+    {
+      s3 = Op::sine(lut, phi[3] + fb);
+      return g[3] * s3
+        + g[2] * Op::sine(lut, phi[2])
+        + g[1] * Op::sine(lut, phi[1])
+        + g[0] * Op::sine(lut, phi[0]);
+    }
+  };
+
+  /**
+   * Four operator phase modulation oscillator.
+   *
+   * Operator phases are uq32 accumulators, the graph is selected at compile time so
+   * that rendering is a straight loop over FM4Algorithm<alg>::tick(). Operator 3 feeds
+   * back onto itself through the average of its last two outputs, which tames the
+   * parasitic oscillation of single sample feedback at high amounts. Operator gains
+   * are ramped linearly over each rendered block.
+   *
+   * Typical use in an oscillator unit, with the firmware sine table:
+   *
+   *   s_fm.init(wt_sine_lut_f);                              // in OSC_INIT
+   *   s_fm.setW0(osc_w0f_for_note(note, mod));               // in OSC_CYCLE
+   *   s_fm.render(yn, frames);
+   *
+   * @tparam alg Algorithm index, see FM4Algorithm
+   * @tparam size_exp Half period sine table size as a power of two exponent, 7 for wt_sine_lut_f
+   */
+  template <uint32_t alg, uint32_t size_exp = 7>
+  struct FM4 {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    typedef FM4Algorithm<alg, size_exp> Algorithm;
+
+    enum {
+      k_op_count = 4,
+      k_feedback_op = 3
+    };
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    FM4(void) :
+      mLut(0), mW0(0.f), mFbGain(0.f)
+    {
+      for (uint32_t i = 0; i < k_op_count; ++i) {
+        mRatio[i] = 1.f;
+        mGain[i] = mGainTarget[i] = 0.f;
+      }
+      reset();
+    }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Initialize with a sine table
+     *
+     * @param lut Half period sine table with (1<<size_exp) entries plus guard point, e.g.: wt_sine_lut_f
+     */
+    inline void init(const float *lut)
+    {
+      mLut = lut;
+      reset();
+    }
+
+    /**
+     * Reset operator phases and feedback history, e.g.: on note on
+     */
+    inline void reset(void)
+    {
+      for (uint32_t i = 0; i < k_op_count; ++i)
+        mPhasor[i].reset();
+      mFb[0] = mFb[1] = 0.f;
+    }
+
+    /**
+     * Check whether an operator is a carrier in the selected algorithm
+     */
+    static inline bool isCarrier(const uint32_t op)
+    {
+      return (Algorithm::k_carriers >> op) & 1;
+    }
+
+    /**
+     * Set base phase increment
+     *
+     * @param w Phase increment in [0, 0.5) range, i.e.: f0 / Fs
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setW0(const float w)
+    {
+      mW0 = w;
+      for (uint32_t i = 0; i < k_op_count; ++i)
+        mPhasor[i].setW0(clipmaxf(w * mRatio[i], 0.49f));
+    }
+
+    /**
+     * Set frequency ratio of an operator relative to the base increment
+     *
+     * @param op Operator index
+     * @param ratio Frequency ratio, e.g.: 0.5, 1, 2, 3.5
+     */
+    inline void setRatio(const uint32_t op, const float ratio)
+    {
+      mRatio[op] = ratio;
+      mPhasor[op].setW0(clipmaxf(mW0 * ratio, 0.49f));
+    }
+
+    /**
+     * Set operator level, reached at the end of the next rendered block
+     *
+     * @param op Operator index
+     * @param level Output amplitude in [0, 1] for carriers, peak phase deviation in radians (modulation index) for modulators
+     */
+    inline void setLevel(const uint32_t op, const float level)
+    {
+      mGainTarget[op] = (isCarrier(op)) ?
+        level * (1.f / Algorithm::k_carrier_count) :
+        clipmaxf(level, k_max_index) * k_rad_to_q24;
+    }
+
+    /**
+     * Set self feedback of operator 3
+     *
+     * @param fb Peak phase deviation in radians, musically useful in [0, M_PI]
+     */
+    inline void setFeedback(const float fb)
+    {
+      // Average of the last two outputs, hence the 0.5
+      mFbGain = 0.5f * clipmaxf(fb, k_max_index) * k_rad_to_q24;
+    }
+
+    /**
+     * Render a block of samples
+     *
+     * @param yn Destination buffer
+     * @param frames Number of samples to render
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(float * __restrict yn, const uint32_t frames)
+    {
+      renderT(yn, frames);
+    }
+
+    /**
+     * Render a block of samples in q31 format, e.g.: into OSC_CYCLE's output buffer
+     *
+     * @param yn Destination buffer
+     * @param frames Number of samples to render
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(q31_t * __restrict yn, const uint32_t frames)
+    {
+      renderT(yn, frames);
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(float *yn, const float y)
+    {
+      *yn = y;
+    }
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void store(q31_t *yn, const float y)
+    {
+      *yn = f32_to_q31(clip1m1f(y));
+    }
+
+    /** @private */
+    template <typename T>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void renderT(T * __restrict yn, const uint32_t frames)
+    {
+      if (!frames)
+        return;
+
+      const float *lut = mLut;
+      const float inv_frames = 1.f / frames;
+      uq32_t phi[k_op_count];
+      uq32_t w0[k_op_count];
+      float g[k_op_count];
+      float dg[k_op_count];
+      for (uint32_t i = 0; i < k_op_count; ++i) {
+        phi[i] = mPhasor[i].phi;
+        w0[i] = mPhasor[i].w0;
+        g[i] = mGain[i];
+        dg[i] = (mGainTarget[i] - g[i]) * inv_frames;
+      }
+      const float fb_gain = mFbGain;
+      float fb0 = mFb[0];
+      float fb1 = mFb[1];
+
+      const T * yn_e = yn + frames;
+      for (; yn != yn_e; ) {
+        float s3;
+        const float y = Algorithm::tick(lut, phi, g, FM4Op<size_exp>::pm(fb_gain * (fb0 + fb1)), s3);
+        store(yn++, y);
+        fb1 = fb0;
+        fb0 = s3;
+        for (uint32_t i = 0; i < k_op_count; ++i) {
+          phi[i] += w0[i];
+          g[i] += dg[i];
+        }
+      }
+
+      for (uint32_t i = 0; i < k_op_count; ++i) {
+        mPhasor[i].phi = phi[i];
+        mGain[i] = mGainTarget[i];
+      }
+      mFb[0] = fb0;
+      mFb[1] = fb1;
+    }
+
+    /*===========================================================================*/
+    /* Constants.                                                                */
+    /*===========================================================================*/
+
+    /** @private Radians to cycles in q24 format */
+    static constexpr float k_rad_to_q24 = 16777216.f / M_TWOPI;
+
+    /** @private Maximum modulation index in radians, keeps offsets within q24 range */
+    static constexpr float k_max_index = 100.f;
+
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    Phasor mPhasor[k_op_count];
+    const float *mLut;
+    float mW0;
+    float mRatio[k_op_count];
+    float mGain[k_op_count];
+    float mGainTarget[k_op_count];
+    float mFbGain;
+    float mFb[2];
+  };
+}
+
+/** @} */
@@ -0,0 +1,232 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    ladder.hpp
+ * @brief   Topology preserving four pole ladder filter.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ */
+
+#include "float_math.h"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Trapezoidal integrated (zero delay feedback) four pole ladder filter.
+   *
+   * Linear model of the classic transistor ladder, with the global feedback loop
+   * resolved analytically so cutoff can be modulated every sample. Two and four
+   * pole low pass and high pass responses are mixed from the stage outputs.
+   */
+  struct Ladder {
+
+    /*=====================================================================*/
+    /* Types and Data Structures.                                          */
+    /*=====================================================================*/
+
+    /**
+     * Filter responses
+     */
+    enum Mode {
+      k_mode_lp4 = 0,
+      k_mode_lp2,
+      k_mode_hp4,
+      k_mode_hp2
+    };
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Ladder(void) :
+      mS1(0), mS2(0), mS3(0), mS4(0),
+      mRes(0), mG(0), mFbGain(1)
+    { }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Flush internal state
+     */
+    inline void flush(void) {
+      mS1 = mS2 = mS3 = mS4 = 0;
+    }
+
+    /**
+     * Set cutoff and resonance
+     *
+     * @param   k Tangent of PI x cutoff frequency in radians: tan(pi*wc), e.g.: osc_tanpif(wc)
+     * @param   res Resonance in [0, 4), self-oscillation at 4
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setCoeffs(const float k, const float res) {
+      mRes = res;
+      setCutoff(k);
+    }
+
+    /**
+     * Set cutoff, keeping current resonance
+     *
+     * @param   k Tangent of PI x cutoff frequency in radians: tan(pi*wc), e.g.: osc_tanpif(wc)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setCutoff(const float k) {
+      const float g = k / (1.f + k);
+      const float g2 = g * g;
+      mG = g;
+      mFbGain = 1.f / (1.f + mRes * g2 * g2);
+    }
+
+    /**
+     * Process one sample
+     *
+     * @tparam  mode Filter response
+     * @param   xn Input sample
+     * @return  Output sample
+     */
+    template <Mode mode>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process(const float xn) {
+      return step<mode>(xn, mG, mFbGain, mRes, mS1, mS2, mS3, mS4);
+    }
+
+    /**
+     * Process a block of samples at fixed cutoff
+     *
+     * @tparam  mode Filter response
+     * @param   xn Input buffer
+     * @param   yn Output buffer, may alias xn
+     * @param   frames Number of samples
+     */
+    template <Mode mode>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float *xn, float *yn, const uint32_t frames) {
+      const float g = mG, fbgain = mFbGain, res = mRes;
+      float s1 = mS1, s2 = mS2, s3 = mS3, s4 = mS4;
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        *(yn++) = step<mode>(*(xn++), g, fbgain, res, s1, s2, s3, s4);
+      }
+      mS1 = s1; mS2 = s2; mS3 = s3; mS4 = s4;
+    }
+
+    /**
+     * Process a block of samples with per-sample cutoff
+     *
+     * @tparam  mode Filter response
+     * @param   xn Input buffer
+     * @param   kn Cutoff buffer, tangent of PI x cutoff frequency in radians: tan(pi*wc)
+     * @param   yn Output buffer, may alias xn
+     * @param   frames Number of samples
+     * @note    Coefficients are left at the last cutoff value of the block.
+     */
+    template <Mode mode>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float *xn, const float *kn, float *yn, const uint32_t frames) {
+      const float res = mRes;
+      float g = mG, fbgain = mFbGain;
+      float s1 = mS1, s2 = mS2, s3 = mS3, s4 = mS4;
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        const float k = *(kn++);
+        g = k / (1.f + k);
+        const float g2 = g * g;
+        fbgain = 1.f / (1.f + res * g2 * g2);
+        *(yn++) = step<mode>(*(xn++), g, fbgain, res, s1, s2, s3, s4);
+      }
+      mS1 = s1; mS2 = s2; mS3 = s3; mS4 = s4;
+      mG = g;
+      mFbGain = fbgain;
+    }
+
+    /*=====================================================================*/
+    /* Private Methods.                                                    */
+    /*=====================================================================*/
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float onepole(const float x, const float g, float &s) {
+      const float v = (x - s) * g;
+      const float y = v + s;
+      s = y + v;
+      return y;
+    }
+
+    /** @private */
+    template <Mode mode>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float step(const float xn, const float g, const float fbgain, const float res,
+               float &s1, float &s2, float &s3, float &s4) {
+      // Instantaneous response of the cascade is y4 = g^4 * u + sigma
+      const float sigma = (1.f - g) * (g * (g * (g * s1 + s2) + s3) + s4);
+      const float u = (xn - res * sigma) * fbgain;
+      const float y1 = onepole(u, g, s1);
+      const float y2 = onepole(y1, g, s2);
+      const float y3 = onepole(y2, g, s3);
+      const float y4 = onepole(y3, g, s4);
+      switch (mode) {
+      case k_mode_lp2:
+        return y2;
+      case k_mode_hp4:
+        return u - 4.f * y1 + 6.f * y2 - 4.f * y3 + y4;
+      case k_mode_hp2:
+        return u - 2.f * y1 + y2;
+      default:
+        return y4;
+      }
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    float mS1, mS2, mS3, mS4;
+    float mRes;
+    float mG;
+    float mFbGain;
+  };
+}
+
+/** @} */
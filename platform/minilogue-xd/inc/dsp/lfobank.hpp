@@ -0,0 +1,462 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    lfobank.hpp
+ * @brief   Bank of LFOs sharing phase and rendering loops.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Bank of N LFOs.
+   *
+   * Phases and increments are kept in parallel q31 arrays, advanced together once per
+   * call, using the same phase convention and wave shapes as SimpleLFO. Values can be
+   * updated at control rate with cycle(), advancing by a whole block at once, or
+   * rendered per sample with render(). Each LFO is either free running or synced to a
+   * number of quarter notes at the current tempo.
+   *
+   * Only depends on the C library so that it can be shared with drumlogue, where
+   * shaping in cycle() and rendering of non random waveforms use NEON, four LFOs or
+   * four samples at a time.
+   *
+   * @tparam N Number of LFOs in the bank
+   */
+  template <uint32_t N>
+  struct LFOBank {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum Waveform {
+      k_wave_sine = 0,
+      k_wave_triangle,
+      k_wave_saw,
+      k_wave_square,
+      k_wave_sample_hold,
+      k_wave_smooth_random,
+      k_wave_count
+    };
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    LFOBank(void) :
+      mFsRecip(1.f / 48000.f),
+      mBeatsPerSec(2.f),
+      mRand(0x2545F491)
+    {
+      for (uint32_t i = 0; i < N; ++i) {
+        mPhi[i] = 0x80000000;
+        mW0[i] = 0;
+        mWave[i] = k_wave_sine;
+        mBeats[i] = 0.f;
+        mRandPrev[i] = mRandNext[i] = 0.f;
+        mValue[i] = 0.f;
+      }
+    }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Set sampling rate the bank is advanced at
+     *
+     * @param fs Sampling frequency in Hz, or control rate when only using cycle()
+     */
+    inline void setSampleRate(const float fs) {
+      mFsRecip = 1.f / fs;
+      updateSynced();
+    }
+
+    /**
+     * Reset all phases
+     */
+    inline void reset(void) {
+      for (uint32_t i = 0; i < N; ++i)
+        mPhi[i] = 0x80000000;
+    }
+
+    /**
+     * Reset phase of a single LFO
+     */
+    inline void reset(const uint32_t idx) {
+      mPhi[idx] = 0x80000000;
+    }
+
+    /**
+     * Set waveform of an LFO
+     */
+    inline void setWaveform(const uint32_t idx, const Waveform wave) {
+      mWave[idx] = (wave < k_wave_count) ? wave : k_wave_sine;
+    }
+
+    /**
+     * Set free running frequency of an LFO
+     *
+     * @param idx LFO index
+     * @param f0 Frequency in Hz
+     */
+    inline void setF0(const uint32_t idx, const float f0) {
+      mBeats[idx] = 0.f;
+      mW0[idx] = f32ToQ31(clipmax(2.f * f0 * mFsRecip, 0.999f));
+    }
+
+    /**
+     * Sync an LFO to tempo
+     *
+     * @param idx LFO index
+     * @param beats Length of one LFO cycle in quarter notes
+     */
+    inline void setSync(const uint32_t idx, const float beats) {
+      mBeats[idx] = clipmin(beats, 1e-3f);
+      updateSynced(idx);
+    }
+
+    /**
+     * Set tempo for synced LFOs
+     *
+     * @param bpm Beats per minute, e.g.: fx_get_bpmf()
+     */
+    inline void setTempo(const float bpm) {
+      mBeatsPerSec = clipmin(bpm, 1.f) * (1.f / 60.f);
+      updateSynced();
+    }
+
+    /**
+     * Set tempo from 16.16 fixed point value, e.g.: as passed to drumlogue's unit_set_tempo()
+     *
+     * @param tempo Beats per minute in 16.16 fixed point
+     */
+    inline void setTempoQ16(const uint32_t tempo) {
+      setTempo((tempo >> 16) + (tempo & 0xFFFF) * 1.52587890625e-005f);
+    }
+
+    /**
+     * Advance all LFOs and update their current values
+     *
+     * @param steps Number of samples to advance by, e.g.: block size when updating at control rate
+     * @note Random waveforms draw a single new value per call, even if several cycles elapsed.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void cycle(const uint32_t steps = 1) {
+      // Phase update kept separate from shaping so the loop stays branch free. Done on
+      // 64 bits from phase -1, so that wraps are detected for any number of steps.
+      for (uint32_t i = 0; i < N; ++i) {
+        const uint64_t u = (uint64_t)((uint32_t)mPhi[i] ^ 0x80000000U) + (uint64_t)(uint32_t)mW0[i] * steps;
+        mWrapped[i] = (u >> 32) != 0;
+        mPhi[i] = (int32_t)((uint32_t)u ^ 0x80000000U);
+      }
+      for (uint32_t i = 0; i < N; ++i) {
+        if (mWrapped[i])
+          drawRandom(i);
+      }
+      uint32_t i = 0;
+#if defined(__ARM_NEON)
+      for (; i + 4 <= N; i += 4)
+        vst1q_f32(&mValue[i], shapeLanes(i));
+#endif
+      for (; i < N; ++i)
+        mValue[i] = shape(i, mPhi[i]);
+    }
+
+    /**
+     * Get current value of an LFO, bipolar in [-1, 1]
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float value(const uint32_t idx) const {
+      return mValue[idx];
+    }
+
+    /**
+     * Get current value of an LFO, unipolar in [0, 1]
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float value_uni(const uint32_t idx) const {
+      return 0.5f + 0.5f * mValue[idx];
+    }
+
+    /**
+     * Render a block of per sample values for all LFOs
+     *
+     * @param yn Output buffer of N * frames values, LFO idx written to yn[idx * frames + n]
+     * @param frames Number of samples to render
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(float * __restrict yn, const uint32_t frames) {
+      if (!frames)
+        return;
+      for (uint32_t i = 0; i < N; ++i, yn += frames) {
+        switch (mWave[i]) {
+        case k_wave_sine:
+          renderLane<k_wave_sine>(i, yn, frames);
+          break;
+        case k_wave_triangle:
+          renderLane<k_wave_triangle>(i, yn, frames);
+          break;
+        case k_wave_saw:
+          renderLane<k_wave_saw>(i, yn, frames);
+          break;
+        case k_wave_square:
+          renderLane<k_wave_square>(i, yn, frames);
+          break;
+        case k_wave_sample_hold:
+          renderLane<k_wave_sample_hold>(i, yn, frames);
+          break;
+        default:
+          renderLane<k_wave_smooth_random>(i, yn, frames);
+          break;
+        }
+        mValue[i] = yn[frames - 1];
+      }
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /** @private */
+    inline void updateSynced(const uint32_t idx) {
+      if (mBeats[idx] > 0.f)
+        mW0[idx] = f32ToQ31(clipmax(2.f * mBeatsPerSec * mFsRecip / mBeats[idx], 0.999f));
+    }
+
+    /** @private */
+    inline void updateSynced(void) {
+      for (uint32_t i = 0; i < N; ++i)
+        updateSynced(i);
+    }
+
+    /** @private */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void drawRandom(const uint32_t idx) {
+      // xorshift32
+      uint32_t r = mRand;
+      r ^= r << 13;
+      r ^= r >> 17;
+      r ^= r << 5;
+      mRand = r;
+      mRandPrev[idx] = mRandNext[idx];
+      mRandNext[idx] = q31ToF32((int32_t)r);
+    }
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float q31ToF32(const int32_t q) {
+      return (float)q * 4.65661287307739e-010f;
+    }
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t f32ToQ31(const float f) {
+      return (int32_t)(f * 2147483647.f);
+    }
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float clipmax(const float x, const float m) {
+      return (x > m) ? m : x;
+    }
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float clipmin(const float x, const float m) {
+      return (x < m) ? m : x;
+    }
+
+    /** @private */
+    template <uint32_t wave>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float shape(const int32_t phi, const float prev, const float next) {
+      switch (wave) {
+      case k_wave_sine:
+        {
+          const float phif = q31ToF32(phi);
+          return 4 * phif * (fabsf(phif) - 1.f);
+        }
+      case k_wave_triangle:
+        return 2.f * fabsf(q31ToF32(phi)) - 1.f;
+      case k_wave_saw:
+        return q31ToF32(phi);
+      case k_wave_square:
+        return (phi < 0) ? -1.f : 1.f;
+      case k_wave_sample_hold:
+        return next;
+      default:
+        {
+          // Smoothstep from previous to next random value over one cycle
+          const float t = 0.5f + 0.5f * q31ToF32(phi);
+          return prev + (next - prev) * t * t * (3.f - 2.f * t);
+        }
+      }
+    }
+
+    /** @private */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float shape(const uint32_t idx, const int32_t phi) const {
+      const float prev = mRandPrev[idx];
+      const float next = mRandNext[idx];
+      switch (mWave[idx]) {
+      case k_wave_sine:
+        return shape<k_wave_sine>(phi, prev, next);
+      case k_wave_triangle:
+        return shape<k_wave_triangle>(phi, prev, next);
+      case k_wave_saw:
+        return shape<k_wave_saw>(phi, prev, next);
+      case k_wave_square:
+        return shape<k_wave_square>(phi, prev, next);
+      case k_wave_sample_hold:
+        return shape<k_wave_sample_hold>(phi, prev, next);
+      default:
+        return shape<k_wave_smooth_random>(phi, prev, next);
+      }
+    }
+
+    /** @private */
+    template <uint32_t wave>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void renderLane(const uint32_t idx, float * __restrict yn, const uint32_t frames) {
+      const bool random = (wave == k_wave_sample_hold || wave == k_wave_smooth_random);
+      uint32_t phi = (uint32_t)mPhi[idx];
+      const uint32_t w0 = (uint32_t)mW0[idx];
+      uint32_t n = 0;
+#if defined(__ARM_NEON)
+      if (!random) {
+        // Four consecutive phases per iteration, wrap around implicit in integer overflow
+        const uint32_t ramp[4] = { w0, 2 * w0, 3 * w0, 4 * w0 };
+        uint32x4_t p = vaddq_u32(vdupq_n_u32(phi), vld1q_u32(ramp));
+        const uint32x4_t step = vdupq_n_u32(4 * w0);
+        const float32x4_t zero = vdupq_n_f32(0.f);
+        for (; n + 4 <= frames; n += 4) {
+          vst1q_f32(yn + n, shapeQ<wave>(vreinterpretq_s32_u32(p), zero, zero));
+          p = vaddq_u32(p, step);
+        }
+        phi += n * w0;
+      }
+#endif
+      for (; n < frames; ++n) {
+        const int32_t next = (int32_t)(phi + w0);
+        if (random && next < (int32_t)phi)
+          drawRandom(idx);
+        phi = (uint32_t)next;
+        yn[n] = shape<wave>(next, mRandPrev[idx], mRandNext[idx]);
+      }
+      mPhi[idx] = (int32_t)phi;
+    }
+
+#if defined(__ARM_NEON)
+
+    /** @private Vector version of shape<wave>() */
+    template <uint32_t wave>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float32x4_t shapeQ(const int32x4_t phi, const float32x4_t prev, const float32x4_t next) {
+      const float32x4_t phif = vmulq_n_f32(vcvtq_f32_s32(phi), 4.65661287307739e-010f);
+      switch (wave) {
+      case k_wave_sine:
+        return vmulq_f32(vmulq_n_f32(phif, 4.f), vsubq_f32(vabsq_f32(phif), vdupq_n_f32(1.f)));
+      case k_wave_triangle:
+        return vmlaq_n_f32(vdupq_n_f32(-1.f), vabsq_f32(phif), 2.f);
+      case k_wave_saw:
+        return phif;
+      case k_wave_square:
+        return vbslq_f32(vcltq_f32(phif, vdupq_n_f32(0.f)), vdupq_n_f32(-1.f), vdupq_n_f32(1.f));
+      case k_wave_sample_hold:
+        return next;
+      default:
+        {
+          const float32x4_t t = vmlaq_n_f32(vdupq_n_f32(0.5f), phif, 0.5f);
+          const float32x4_t s = vmulq_f32(vmulq_f32(t, t), vmlsq_n_f32(vdupq_n_f32(3.f), t, 2.f));
+          return vmlaq_f32(prev, vsubq_f32(next, prev), s);
+        }
+      }
+    }
+
+    /** @private Current values of LFOs idx to idx+3, shapes selected per lane */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float32x4_t shapeLanes(const uint32_t idx) const {
+      const int32x4_t phi = vld1q_s32(&mPhi[idx]);
+      const float32x4_t prev = vld1q_f32(&mRandPrev[idx]);
+      const float32x4_t next = vld1q_f32(&mRandNext[idx]);
+      const uint32_t waves[4] = { mWave[idx], mWave[idx+1], mWave[idx+2], mWave[idx+3] };
+      const uint32x4_t w = vld1q_u32(waves);
+      float32x4_t y = shapeQ<k_wave_sine>(phi, prev, next);
+      y = vbslq_f32(vceqq_u32(w, vdupq_n_u32(k_wave_triangle)), shapeQ<k_wave_triangle>(phi, prev, next), y);
+      y = vbslq_f32(vceqq_u32(w, vdupq_n_u32(k_wave_saw)), shapeQ<k_wave_saw>(phi, prev, next), y);
+      y = vbslq_f32(vceqq_u32(w, vdupq_n_u32(k_wave_square)), shapeQ<k_wave_square>(phi, prev, next), y);
+      y = vbslq_f32(vceqq_u32(w, vdupq_n_u32(k_wave_sample_hold)), next, y);
+      return vbslq_f32(vceqq_u32(w, vdupq_n_u32(k_wave_smooth_random)),
+                       shapeQ<k_wave_smooth_random>(phi, prev, next), y);
+    }
+
+#endif
+
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    int32_t  mPhi[N];
+    int32_t  mW0[N];
+    float    mValue[N];
+    float    mBeats[N];
+    float    mRandPrev[N];
+    float    mRandNext[N];
+    uint8_t  mWave[N];
+    uint8_t  mWrapped[N];
+    float    mFsRecip;
+    float    mBeatsPerSec;
+    uint32_t mRand;
+  };
+}
+
+/** @} */
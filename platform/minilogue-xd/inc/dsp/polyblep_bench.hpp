@@ -0,0 +1,125 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    polyblep_bench.hpp
+ * @brief   Cost comparison of PolyBLEPOsc against the band-limited saw lookup tables.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ * Timing relies on profile.h, so define PROFILE_ENABLE to get cycle counts on target
+ * (DWT) or nanoseconds on host, otherwise results are zero. The lookup table path relies
+ * on osc_api.h firmware tables, so this is meant to be built as part of an oscillator.
+ *
+ * Typical use from an oscillator build, e.g.: reporting ticks via a debugger:
+ * @code
+ * static float s_bench_buf[64];
+ * static dsp::PolyBLEPBenchResult s_bench;
+ *
+ * void OSC_INIT(uint32_t platform, uint32_t api) {
+ *   profile_init();
+ *   dsp::benchPolyBLEPSaw(s_bench_buf, 64, 256, 60, &s_bench);
+ * }
+ * @endcode
+ */
+
+#include "osc_api.h"
+#include "profile.h"
+#include "polyblep.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Results of benchPolyBLEPSaw()
+   */
+  typedef struct PolyBLEPBenchResult {
+    float polyblep_ticks;  /**< Average ticks per sample of PolyBLEPOsc saw */
+    float lut_ticks;       /**< Average ticks per sample of osc_bl2_sawf() with osc_bl_saw_idx() */
+  } PolyBLEPBenchResult;
+
+  /**
+   * Render a saw at a fixed note with PolyBLEPOsc and with the firmware band-limited tables
+   *
+   * Both paths update their pitch once per block, as an oscillator's OSC_CYCLE would.
+   *
+   * @param buf Work buffer of frames floats
+   * @param frames Block size in samples
+   * @param blocks Number of blocks to render
+   * @param note MIDI note
+   * @param res Results
+   */
+  inline void benchPolyBLEPSaw(float *buf, const uint32_t frames, const uint32_t blocks,
+                               const uint8_t note, PolyBLEPBenchResult *res) {
+#if defined(PROFILE_ENABLE)
+    volatile float sink = 0.f;
+    uint64_t polyblep_ticks = 0;
+    uint64_t lut_ticks = 0;
+
+    PolyBLEPOsc osc;
+    for (uint32_t b = 0; b < blocks; ++b) {
+      const uint32_t t0 = profile_now();
+      osc.setW0(osc_w0f_for_note(note, 0));
+      osc.render<PolyBLEPOsc::k_waveform_saw>(buf, frames);
+      polyblep_ticks += profile_now() - t0;
+      sink = sink + buf[frames - 1];
+    }
+
+    float phase = 0.f;
+    for (uint32_t b = 0; b < blocks; ++b) {
+      const uint32_t t0 = profile_now();
+      const float w0 = osc_w0f_for_note(note, 0);
+      const float idx = osc_bl_saw_idx(note);
+      for (uint32_t i = 0; i < frames; ++i) {
+        buf[i] = osc_bl2_sawf(phase, idx);
+        phase += w0;
+        phase -= (uint32_t)phase;
+      }
+      lut_ticks += profile_now() - t0;
+      sink = sink + buf[frames - 1];
+    }
+
+    res->polyblep_ticks = (float)polyblep_ticks / (blocks * frames);
+    res->lut_ticks = (float)lut_ticks / (blocks * frames);
+#else
+    (void)buf; (void)frames; (void)blocks; (void)note;
+    res->polyblep_ticks = res->lut_ticks = 0.f;
+#endif
+  }
+}
+
+/** @} */
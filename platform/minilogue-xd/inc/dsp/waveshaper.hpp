@@ -0,0 +1,536 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    waveshaper.hpp
+ * @brief   Antiderivative anti-aliased waveshapers.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ */
+
+#include "float_math.h"
+#include "waveshaper_lut.h"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Odd-symmetric shaping function with first and second antiderivatives, sampled on [0, range].
+   *
+   * Only refers to the tables, which are meant to be const data such as the ones in
+   * waveshaper_lut.h, so instances are cheap and can live in ROM. Antiderivative tables
+   * must be integrated from the linear interpolation of the shaping function, and the
+   * curve is held constant beyond range.
+   *
+   * @tparam size_exp Table size as a power of two exponent.
+   */
+  template <uint32_t size_exp>
+  struct ShaperTable {
+
+    /*=====================================================================*/
+    /* Types and Data Structures.                                          */
+    /*=====================================================================*/
+
+    enum {
+      k_size = (1U<<size_exp),
+      k_lut_size = k_size + 1
+    };
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Constructor
+     *
+     * @param f0 Table of k_lut_size values sampling the curve on [0, range]
+     * @param f1 First antiderivative table
+     * @param f2 Second antiderivative table
+     * @param range Input value corresponding to last table entry
+     */
+    ShaperTable(const float *f0, const float *f1, const float *f2, const float range = 1.f) :
+      mF0(f0), mF1(f1), mF2(f2),
+      mScale(k_size / range),
+      mStep(range / k_size)
+    { }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Shaping function
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f0(const float x) const {
+      const float xf = si_fabsf(x) * mScale;
+      if (xf >= k_size)
+        return si_copysignf(mF0[k_size], x);
+      const uint32_t xi = (uint32_t)xf;
+      return si_copysignf(linintf(xf - xi, mF0[xi], mF0[xi+1]), x);
+    }
+
+    /**
+     * First antiderivative of shaping function (even)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f1(const float x) const {
+      const float xf = si_fabsf(x) * mScale;
+      if (xf >= k_size) {
+        const float d = (xf - k_size) * mStep;
+        return mF1[k_size] + d * mF0[k_size];
+      }
+      const uint32_t xi = (uint32_t)xf;
+      const float d = (xf - xi) * mStep;
+      const float slope = (mF0[xi+1] - mF0[xi]) * mScale;
+      return mF1[xi] + d * (mF0[xi] + 0.5f * slope * d);
+    }
+
+    /**
+     * Second antiderivative of shaping function (odd)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f2(const float x) const {
+      const float xf = si_fabsf(x) * mScale;
+      if (xf >= k_size) {
+        const float d = (xf - k_size) * mStep;
+        return si_copysignf(mF2[k_size] + d * (mF1[k_size] + 0.5f * mF0[k_size] * d), x);
+      }
+      const uint32_t xi = (uint32_t)xf;
+      const float d = (xf - xi) * mStep;
+      const float slope = (mF0[xi+1] - mF0[xi]) * mScale;
+      return si_copysignf(mF2[xi] + d * (mF1[xi] + d * (0.5f * mF0[xi] + 0.16666667f * slope * d)), x);
+    }
+
+    /**
+     * Mean of first antiderivative over [a, b], i.e.: (f2(b) - f2(a)) / (b - a)
+     *
+     * Integrated within table segments so that large f2 values are never subtracted,
+     * exact when a and b are within two adjacent segments, and f1(a) when a == b.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f1mean(const float a, const float b) const {
+      if ((a < 0.f) != (b < 0.f) && a != 0.f && b != 0.f) {
+        // Odd f2 values of opposite signs add up, no cancellation
+        return (f2(b) - f2(a)) / (b - a);
+      }
+      // Even f1, work on magnitudes in table units
+      float lo = si_fabsf(a) * mScale;
+      float hi = si_fabsf(b) * mScale;
+      if (lo > hi) {
+        const float t = lo;
+        lo = hi;
+        hi = t;
+      }
+      const uint32_t ilo = segment(lo);
+      const uint32_t ihi = segment(hi);
+      const float tlo = (lo - ilo) * mStep;
+      const float thi = (hi - ihi) * mStep;
+      if (ilo == ihi)
+        return segmentMean(ilo, tlo, thi);
+      if (ilo + 1 == ihi) {
+        // Split at segment boundary, both parts weighted by their length
+        const float len_lo = mStep - tlo;
+        return (len_lo * segmentMean(ilo, tlo, mStep) + thi * segmentMean(ihi, 0.f, thi)) / (len_lo + thi);
+      }
+      // Far apart, difference is well conditioned
+      return (f2(b) - f2(a)) / (b - a);
+    }
+
+    /*=====================================================================*/
+    /* Private Methods.                                                    */
+    /*=====================================================================*/
+
+    /** @private Segment index of a magnitude in table units, k_size beyond range */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t segment(const float xf) const {
+      return (xf >= k_size) ? k_size : (uint32_t)xf;
+    }
+
+    /** @private Mean of f1 over [ta, tb] relative to start of segment i */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float segmentMean(const uint32_t i, const float ta, const float tb) const {
+      const float slope = (i < k_size) ? (mF0[i+1] - mF0[i]) * mScale : 0.f;
+      return mF1[i] + 0.5f * mF0[i] * (ta + tb) + 0.16666667f * slope * (ta * ta + ta * tb + tb * tb);
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    const float *mF0;
+    const float *mF1;
+    const float *mF2;
+    float mScale;
+    float mStep;
+  };
+
+  /**
+   * Tanh shaper using precomputed tables, saturates past +/-4.
+   */
+  struct TanhShaper : public ShaperTable<k_shaper_size_exp> {
+    TanhShaper(void) :
+      ShaperTable<k_shaper_size_exp>(tanh_shaper_lut_f, tanh_shaper_int1_lut_f, tanh_shaper_int2_lut_f,
+                                     k_tanh_shaper_range)
+    { }
+  };
+
+  /**
+   * Cubic soft clipper using precomputed tables, saturates past +/-1.
+   */
+  struct CubicShaper : public ShaperTable<k_shaper_size_exp> {
+    CubicShaper(void) :
+      ShaperTable<k_shaper_size_exp>(cubic_shaper_lut_f, cubic_shaper_int1_lut_f, cubic_shaper_int2_lut_f,
+                                     k_cubic_shaper_range)
+    { }
+  };
+
+  /**
+   * Shaping tables integrated at initialization.
+   *
+   * For curves only available at runtime, e.g.: the firmware's cubicsat_lut_f and
+   * schetzen_lut_f, or a function such as fastertanhf. Costs 3 * k_lut_size floats
+   * of RAM per instance, so prefer precomputed tables and share instances otherwise.
+   *
+   * @tparam size_exp Table size as a power of two exponent.
+   */
+  template <uint32_t size_exp>
+  struct ShaperTableBuffer : public ShaperTable<size_exp> {
+
+    typedef ShaperTable<size_exp> Base;
+
+    /**
+     * Default constructor
+     */
+    ShaperTableBuffer(void) :
+      Base(mBuf[0], mBuf[1], mBuf[2])
+    {
+      for (uint32_t i = 0; i < Base::k_lut_size; ++i)
+        mBuf[0][i] = mBuf[1][i] = mBuf[2][i] = 0.f;
+    }
+
+    /**
+     * Build from a half-curve lookup table.
+     *
+     * @param lut Table of k_lut_size values sampling the curve on [0, range], e.g.: cubicsat_lut_f
+     * @param range Input value corresponding to last table entry
+     */
+    inline void init(const float *lut, const float range = 1.f) {
+      for (uint32_t i = 0; i < Base::k_lut_size; ++i)
+        mBuf[0][i] = lut[i];
+      integrate(range);
+    }
+
+    /**
+     * Build by sampling a function on [0, range].
+     *
+     * @param fn Shaping function, only evaluated for positive inputs, e.g.: fastertanhf
+     * @param range Input value after which the curve is held constant
+     */
+    inline void init(float (*fn)(float), const float range) {
+      const float step = range / Base::k_size;
+      for (uint32_t i = 0; i < Base::k_lut_size; ++i)
+        mBuf[0][i] = fn(i * step);
+      mBuf[0][0] = 0.f;
+      integrate(range);
+    }
+
+    /** @private */
+    inline void integrate(const float range) {
+      this->mScale = Base::k_size / range;
+      this->mStep = range / Base::k_size;
+      const float h = this->mStep;
+      float *f0 = mBuf[0];
+      float *f1 = mBuf[1];
+      float *f2 = mBuf[2];
+      f1[0] = f2[0] = 0.f;
+      for (uint32_t i = 0; i < Base::k_size; ++i) {
+        const float slope = (f0[i+1] - f0[i]) * this->mScale;
+        f1[i+1] = f1[i] + h * (f0[i] + 0.5f * slope * h);
+        f2[i+1] = f2[i] + h * (f1[i] + h * (0.5f * f0[i] + 0.16666667f * slope * h));
+      }
+    }
+
+    float mBuf[3][Base::k_lut_size];
+  };
+
+  /**
+   * Hard clipper to [-1, 1] with analytic antiderivatives.
+   */
+  struct HardClipShaper {
+
+    /**
+     * Shaping function
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f0(const float x) const {
+      return clip1m1f(x);
+    }
+
+    /**
+     * First antiderivative of shaping function (even)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f1(const float x) const {
+      const float ax = si_fabsf(x);
+      return (ax <= 1.f) ? 0.5f * x * x : ax - 0.5f;
+    }
+
+    /**
+     * Second antiderivative of shaping function (odd)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f2(const float x) const {
+      const float ax = si_fabsf(x);
+      return (ax <= 1.f) ? 0.16666667f * x * x * x : si_copysignf(0.5f * x * x + 0.16666667f, x) - 0.5f * x;
+    }
+
+    /**
+     * Mean of first antiderivative over [a, b], i.e.: (f2(b) - f2(a)) / (b - a)
+     *
+     * Integrated separately over the clipped and linear regions, f1(a) when a == b.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float f1mean(const float a, const float b) const {
+      const float lo = (a < b) ? a : b;
+      const float hi = (a < b) ? b : a;
+      const float len = hi - lo;
+      if (len == 0.f)
+        return f1(a);
+      float sum = 0.f;
+      if (lo < -1.f) {
+        // f1 = -x - 1/2
+        const float e = (hi < -1.f) ? hi : -1.f;
+        sum += (e - lo) * (-0.5f * (lo + e) - 0.5f);
+      }
+      if (hi > 1.f) {
+        // f1 = x - 1/2
+        const float s = (lo > 1.f) ? lo : 1.f;
+        sum += (hi - s) * (0.5f * (s + hi) - 0.5f);
+      }
+      const float s = (lo > -1.f) ? lo : -1.f;
+      const float e = (hi < 1.f) ? hi : 1.f;
+      if (e > s) {
+        // f1 = x^2 / 2
+        sum += (e - s) * 0.16666667f * (s * s + s * e + e * e);
+      }
+      return sum / len;
+    }
+  };
+
+  /**
+   * First order antiderivative anti-aliased waveshaper.
+   *
+   * @tparam Shaper Type providing f0(), f1() and f2(), e.g.: dsp::TanhShaper, dsp::ShaperTableBuffer or dsp::HardClipShaper
+   */
+  template <typename Shaper>
+  struct ADAA1 {
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Constructor
+     *
+     * @param shaper Shaping function, can be shared between instances, must outlive this object
+     */
+    ADAA1(const Shaper &shaper) :
+      mShaper(&shaper), mX1(0), mF1Z(shaper.f1(0.f))
+    { }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Set shaping function
+     */
+    inline void setShaper(const Shaper &shaper) {
+      mShaper = &shaper;
+      mF1Z = shaper.f1(mX1);
+    }
+
+    /**
+     * Flush internal delays
+     */
+    inline void flush(void) {
+      mX1 = 0;
+      mF1Z = mShaper->f1(0.f);
+    }
+
+    /**
+     * Process one sample
+     *
+     * @param xn Input sample
+     * @return Output sample, delayed by half a sample
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process(const float xn) {
+      const float f1 = mShaper->f1(xn);
+      const float dx = xn - mX1;
+      const float y = (si_fabsf(dx) < k_adaa1_eps) ?
+        mShaper->f0(0.5f * (xn + mX1)) :
+        (f1 - mF1Z) / dx;
+      mX1 = xn;
+      mF1Z = f1;
+      return y;
+    }
+
+    /**
+     * Process a block of samples
+     *
+     * @param xn Input buffer
+     * @param yn Output buffer, may alias xn
+     * @param frames Number of samples
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float *xn, float *yn, const uint32_t frames) {
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        *(yn++) = process(*(xn++));
+      }
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    static constexpr float k_adaa1_eps = 1e-4f;
+
+    const Shaper *mShaper;
+    float mX1;
+    float mF1Z;
+  };
+
+  /**
+   * Second order antiderivative anti-aliased waveshaper.
+   *
+   * First divided differences of f2 come from the shaper's f1mean(), which avoids
+   * subtracting large f2 values, and second differences fall back to the shaping function
+   * at the centroid of the last three inputs when they are too close relative to their
+   * magnitude. This keeps single precision errors small at high drive.
+   *
+   * @tparam Shaper Type providing f0(), f1(), f2() and f1mean(), e.g.: dsp::TanhShaper, dsp::ShaperTableBuffer or dsp::HardClipShaper
+   */
+  template <typename Shaper>
+  struct ADAA2 {
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Constructor
+     *
+     * @param shaper Shaping function, can be shared between instances, must outlive this object
+     */
+    ADAA2(const Shaper &shaper) :
+      mShaper(&shaper), mX1(0), mX2(0), mD1(shaper.f1(0.f))
+    { }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Set shaping function
+     */
+    inline void setShaper(const Shaper &shaper) {
+      mShaper = &shaper;
+      flush();
+    }
+
+    /**
+     * Flush internal delays
+     */
+    inline void flush(void) {
+      mX1 = mX2 = 0;
+      mD1 = mShaper->f1(0.f);
+    }
+
+    /**
+     * Process one sample
+     *
+     * @param xn Input sample
+     * @return Output sample, delayed by one sample
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process(const float xn) {
+      const Shaper &s = *mShaper;
+      const float d = s.f1mean(mX1, xn);
+      const float dx2 = xn - mX2;
+      // Rounding errors of d and mD1 scale with input magnitude
+      const float y = (si_fabsf(dx2) > k_adaa2_eps * (1.f + si_fabsf(xn))) ?
+        2.f * (d - mD1) / dx2 :
+        s.f0(0.33333333f * (xn + mX1 + mX2));
+
+      mX2 = mX1;
+      mX1 = xn;
+      mD1 = d;
+      return y;
+    }
+
+    /**
+     * Process a block of samples
+     *
+     * @param xn Input buffer
+     * @param yn Output buffer, may alias xn
+     * @param frames Number of samples
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float *xn, float *yn, const uint32_t frames) {
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        *(yn++) = process(*(xn++));
+      }
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    static constexpr float k_adaa2_eps = 1e-3f;
+
+    const Shaper *mShaper;
+    float mX1, mX2;
+    float mD1;
+  };
+}
+
+/** @} */
@@ -569,6 +569,91 @@ extern "C" {
     return linintf(fr, w[x0], w[x1]);
   }
   
+  /** @} */
+
+  /**
+   * @name   Compressed waves
+   * @note   q15 waves take half the memory of float waves. They have the same
+   *         k_waves_lut_size entries, the last one being a copy of the first,
+   *         so that adjacent samples can be fetched with a single word load.
+   *         Interpolation weights are 14-bit, dequantization is folded into the
+   *         final conversion.
+   * @{
+   */
+
+#define k_waves_q15_frshift  (k_waves_u32shift - 14)
+#define k_waves_q15_frmask   ((1U<<14)-1)
+#define k_waves_q15_one      (1U<<14)
+#define k_waves_q29_to_f32_c (1.86264514923096e-009f) // 1/(1<<29)
+
+  /** Pair of adjacent q15 samples, possibly at an odd halfword address */
+  typedef simd32_t __attribute__((may_alias, aligned(2))) q15x2_unaligned_t;
+
+  /**
+   * Convert a float wave to q15 format
+   *
+   * @param src Float wave, at least k_waves_size entries
+   * @param dst q15 wave, k_waves_lut_size entries
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  void osc_wave_f32_to_q15(const float *src, q15_t *dst) {
+    for (uint32_t i = 0; i < k_waves_size; ++i)
+      dst[i] = f32_to_q15(src[i]);
+    dst[k_waves_size] = dst[0];
+  }
+
+  /**
+   * Interpolated q15 wave lookup, q29 result
+   *
+   * @param w q15 wave with guard point
+   * @param x Phase in [0, 1<<31), as for osc_wave_scanuf
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  q31_t osc_wave_scanuq15_q29(const q15_t *w, uint32_t x) {
+    const uint32_t x0 = (x>>k_waves_u32shift);
+    const q31_t fr = (x>>k_waves_q15_frshift) & k_waves_q15_frmask;
+    // Unaligned word loads are supported, low half is w[x0], high half w[x0+1]
+    const simd32_t pair = *((const q15x2_unaligned_t *)(w + x0));
+    return smuad(pair, pkhbt(k_waves_q15_one - fr, fr, 16));
+  }
+
+  /**
+   * Interpolated q15 wave lookup
+   *
+   * @param w q15 wave with guard point
+   * @param x Phase in [0, 1<<31), as for osc_wave_scanuf
+   * @return Value in q31 format
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  q31_t osc_wave_scanuq15(const q15_t *w, uint32_t x) {
+    return osc_wave_scanuq15_q29(w, x) << 2;
+  }
+
+  /**
+   * Interpolated q15 wave lookup
+   *
+   * @param w q15 wave with guard point
+   * @param x Phase in [0, 1<<31), as for osc_wave_scanuf
+   * @return Value as float
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  float osc_wave_scanuq15f(const q15_t *w, uint32_t x) {
+    return k_waves_q29_to_f32_c * (float)osc_wave_scanuq15_q29(w, x);
+  }
+
+  /**
+   * Interpolated q15 wave lookup
+   *
+   * @param w q15 wave with guard point
+   * @param x Phase in cycles, fractional part is used
+   * @return Value as float
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  float osc_wave_scanq15f(const q15_t *w, float x) {
+    const float p = x - (uint32_t)x;
+    return osc_wave_scanuq15f(w, (uint32_t)(p * (1U<<31)));
+  }
+  
   /** @} */
   
   /*===========================================================================*/
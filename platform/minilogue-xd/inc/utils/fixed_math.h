@@ -135,6 +135,7 @@ typedef uint64_t uq64_0_t;
 
 #define q15_to_f32_c 3.05175781250000e-005f
 #define q31_to_f32_c 4.65661287307739e-010f
+#define uq32_to_f32_c 2.32830643653870e-010f
 
 #define q15_to_f32(q) ((float)(q) * q15_to_f32_c)
 #define q31_to_f32(q) ((float)(q) * q31_to_f32_c)
@@ -142,6 +143,9 @@ typedef uint64_t uq64_0_t;
 #define f32_to_q15(f)   ((q15_t)ssat((q31_t)((float)(f) * ((1<<15)-1)),16))
 #define f32_to_q31(f)   ((q31_t)((float)(f) * (float)0x7FFFFFFF))
 
+#define uq32_to_f32(q)  ((float)(uq32_t)(q) * uq32_to_f32_c)
+#define f32_to_uq32(f)  ((uq32_t)(int64_t)((float)(f) * 4294967296.f)) // wraps f modulo 1, |f| < 2^31
+
 /** @} */
 
 /*===========================================================================*/
@@ -127,6 +127,9 @@
 #define M_1_SQRT2 0.7071067811865475f
 #endif
 
+/** Tiny offset that keeps decaying recursive states above denormal range */
+#define k_f32_anti_denormal 1e-20f
+
 /** @} */
 
 /*===========================================================================*/
@@ -312,6 +315,15 @@ float si_roundf(float x)
   return (float)((int32_t)(x + si_copysignf(0.5f,x)));
 }
 
+/** Flush denormal values to zero
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float si_flush_denormf(float x)
+{
+  f32_t xs = {x};
+  return (xs.i & 0x7f800000) ? x : 0.f;
+}
+
 static inline __attribute__((optimize("Ofast"), always_inline))
 float clampfsel(const float min, float x, const float max)
 {
@@ -677,9 +689,10 @@ float fasterlogf(float x) {
  */
 static inline __attribute__((optimize("Ofast"), always_inline))
 float fastpow2f(float p) {
+  float offset = (p < 0) ? 1.0f : 0.0f;
   float clipp = (p < -126) ? -126.0f : p;
   int w = clipp;
-  float z = clipp - w + 1.f;
+  float z = clipp - w + offset;
   union { uint32_t i; float f; } v = { (uint32_t) ( (1 << 23) * 
       (clipp + 121.2740575f + 27.7280233f / (4.84252568f - z) - 1.49012907f * z)
       ) };
@@ -752,8 +765,9 @@ float fasteratan2f(float y, float x) {
   return (y < 0) ? -angle : angle; // negate if in quad III or IV
 }
 
-/** Hyperbolic tangent approximation
+/** Hyperbolic tangent approximation, valid for x in [0, 3.5]
  * @note Adapted from http://math.stackexchange.com/questions/107292/rapid-approximation-of-tanhx
+ * @note Not odd symmetric, see tier_tanhf() for a full domain version.
  */
 static inline __attribute__((optimize("Ofast"), always_inline))
 float fastertanhf(float x) {
@@ -789,7 +803,7 @@ float ampdbf(const float amp) {
  */
 static inline __attribute__((optimize("Ofast"), always_inline))
 float fasterampdbf(const float amp) {
-  static const float c = 3.3219280948873626f; // 20.f / log2f(10);
+  static const float c = 6.020599913279624f; // 20.f / log2f(10);
   return c*fasterlog2f(amp);
 }
 
@@ -809,6 +823,183 @@ float fasterdbampf(const float db) {
 
 /** @} */
 
+/*===========================================================================*/
+/* Approximation Tiers.                                                      */
+/*===========================================================================*/
+
+/**
+ * @name    Approximation Tiers
+ *
+ * The tier_* functions resolve at compile time to the libc, "fast" or "faster"
+ * version of a function, so that a unit can trade accuracy for speed globally,
+ * e.g.: UDEFS = -DFLOAT_MATH_TIER=FLOAT_MATH_TIER_FASTER. Families can be
+ * overridden individually with FLOAT_MATH_TIER_TRIG, FLOAT_MATH_TIER_LOG,
+ * FLOAT_MATH_TIER_EXP and FLOAT_MATH_TIER_TANH.
+ *
+ * Measured with float_math_bench.h on host (libc references):
+ *
+ * | function     | fast: max err | faster: max err | domain          |
+ * |--------------|---------------|-----------------|-----------------|
+ * | sin, cos     | 3.9e-5        | 8.9e-4, 6.5e-3  | [-pi, pi]       |
+ * | log2         | 1.5e-4        | 5.7e-2          | [1e-3, 1e3]     |
+ * | pow2, exp    | 6.5e-5 rel.   | 3.9e-2 rel.     | [-20, 20]       |
+ * | tanh         | 1.5e-3        | 2.4e-2          | full            |
+ * | dbamp        | 6.1e-5 rel.   | 7.0e-2 rel.     | [-96, 24] dB    |
+ * | ampdb        | 9.1e-4 dB     | 3.5e-1 dB       | [1e-4, 16]      |
+ *
+ * On Cortex-M4 "faster" versions of sin, log2 and pow2 reduce to a few single
+ * cycle FPU and integer operations, whereas "fast" log2 and pow2 and both tanh
+ * tiers involve a division (14 cycles). Use float_math_bench.h with
+ * PROFILE_ENABLE to obtain cycle counts on target.
+ * @{
+ */
+
+#define FLOAT_MATH_TIER_EXACT  0
+#define FLOAT_MATH_TIER_FAST   1
+#define FLOAT_MATH_TIER_FASTER 2
+
+#ifndef FLOAT_MATH_TIER
+#define FLOAT_MATH_TIER FLOAT_MATH_TIER_FAST
+#endif
+
+#ifndef FLOAT_MATH_TIER_TRIG
+#define FLOAT_MATH_TIER_TRIG FLOAT_MATH_TIER
+#endif
+
+#ifndef FLOAT_MATH_TIER_LOG
+#define FLOAT_MATH_TIER_LOG FLOAT_MATH_TIER
+#endif
+
+#ifndef FLOAT_MATH_TIER_EXP
+#define FLOAT_MATH_TIER_EXP FLOAT_MATH_TIER
+#endif
+
+#ifndef FLOAT_MATH_TIER_TANH
+#define FLOAT_MATH_TIER_TANH FLOAT_MATH_TIER
+#endif
+
+/** Sine, valid for x in [-M_PI, M_PI]
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_sinf(float x) {
+#if FLOAT_MATH_TIER_TRIG == FLOAT_MATH_TIER_EXACT
+  return sinf(x);
+#elif FLOAT_MATH_TIER_TRIG == FLOAT_MATH_TIER_FAST
+  return fastsinf(x);
+#else
+  return fastersinf(x);
+#endif
+}
+
+/** Sine, valid on full x domain
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_sinfullf(float x) {
+#if FLOAT_MATH_TIER_TRIG == FLOAT_MATH_TIER_EXACT
+  return sinf(x);
+#elif FLOAT_MATH_TIER_TRIG == FLOAT_MATH_TIER_FAST
+  return fastsinfullf(x);
+#else
+  return fastersinfullf(x);
+#endif
+}
+
+/** Cosine, valid for x in [-M_PI, M_PI]
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_cosf(float x) {
+#if FLOAT_MATH_TIER_TRIG == FLOAT_MATH_TIER_EXACT
+  return cosf(x);
+#elif FLOAT_MATH_TIER_TRIG == FLOAT_MATH_TIER_FAST
+  return fastcosf(x);
+#else
+  return fastercosf(x);
+#endif
+}
+
+/** Log base 2, valid for positive x
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_log2f(float x) {
+#if FLOAT_MATH_TIER_LOG == FLOAT_MATH_TIER_EXACT
+  return log2f(x);
+#elif FLOAT_MATH_TIER_LOG == FLOAT_MATH_TIER_FAST
+  return fastlog2f(x);
+#else
+  return fasterlog2f(x);
+#endif
+}
+
+/** Power of 2, valid for x in [-126, 127]
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_pow2f(float x) {
+#if FLOAT_MATH_TIER_EXP == FLOAT_MATH_TIER_EXACT
+  return powf(2.f, x);
+#elif FLOAT_MATH_TIER_EXP == FLOAT_MATH_TIER_FAST
+  return fastpow2f(x);
+#else
+  return fasterpow2f(x);
+#endif
+}
+
+/** Exponential, valid for x in [~ -87, ~ 88]
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_expf(float x) {
+#if FLOAT_MATH_TIER_EXP == FLOAT_MATH_TIER_EXACT
+  return expf(x);
+#elif FLOAT_MATH_TIER_EXP == FLOAT_MATH_TIER_FAST
+  return fastexpf(x);
+#else
+  return fasterexpf(x);
+#endif
+}
+
+/** Hyperbolic tangent, valid on full x domain
+ * @note "Faster" tier is a Pade approximant, exact at 0 and saturating at |x| = 3.
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_tanhf(float x) {
+#if FLOAT_MATH_TIER_TANH == FLOAT_MATH_TIER_EXACT
+  return tanhf(x);
+#elif FLOAT_MATH_TIER_TANH == FLOAT_MATH_TIER_FAST
+  return si_copysignf(fastertanhf(clipmaxf(si_fabsf(x), 3.5f)), x);
+#else
+  x = clipminmaxf(-3.f, x, 3.f);
+  const float x2 = x * x;
+  return x * (27.f + x2) / (27.f + 9.f * x2);
+#endif
+}
+
+/** dB to amplitude
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_dbampf(float db) {
+#if FLOAT_MATH_TIER_EXP == FLOAT_MATH_TIER_EXACT
+  return dbampf(db);
+#elif FLOAT_MATH_TIER_EXP == FLOAT_MATH_TIER_FAST
+  return fastpow2f(0.16609640474436813f * db); // log2(10) / 20
+#else
+  return fasterdbampf(db);
+#endif
+}
+
+/** Amplitude to dB, valid for positive amp
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float tier_ampdbf(float amp) {
+#if FLOAT_MATH_TIER_LOG == FLOAT_MATH_TIER_EXACT
+  return 20.f * log10f(amp);
+#elif FLOAT_MATH_TIER_LOG == FLOAT_MATH_TIER_FAST
+  return 6.020599913279624f * fastlog2f(amp); // 20 / log2(10)
+#else
+  return fasterampdbf(amp);
+#endif
+}
+
+/** @} */
+
 /*===========================================================================*/
 /* Interpolation.                                                            */
 /*===========================================================================*/
@@ -0,0 +1,231 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+/**
+ * @file    float_math_bench.h
+ * @brief   Accuracy and cost measurements for float_math.h approximations.
+ *
+ * @addtogroup utils Utils
+ * @{
+ *
+ * @addtogroup utils_float_math_bench Floating-Point Math Benchmarks
+ * @{
+ *
+ * Sweeps an approximation over its domain against a reference and reports
+ * maximum and RMS error along with the average cost per call. Timing relies on
+ * profile.h, so define PROFILE_ENABLE to get cycle counts on target (DWT) or
+ * nanoseconds on host, otherwise only errors are measured.
+ *
+ * Functions are called through pointers, the cost of an empty call measured
+ * the same way is subtracted from the results. Firmware LUT versions such as
+ * osc_sinf or fx_pow2f can be measured by wrapping them in a function taking
+ * and returning a float.
+ *
+ */
+
+#ifndef __float_math_bench_h
+#define __float_math_bench_h
+
+#include <stdint.h>
+
+#include "float_math.h"
+#include "profile.h"
+
+#if !defined(__ARM_ARCH_7EM__)
+#include <stdio.h>
+#endif
+
+/*===========================================================================*/
+/* Types.                                                                    */
+/*===========================================================================*/
+
+/**
+ * @name    Types
+ * @{
+ */
+
+typedef float (*fmb_func_t)(float);
+
+/** Error is measured relative to the reference value */
+#define FMB_REL_ERROR (1U<<0)
+
+typedef struct fmb_entry {
+  const char *name;
+  fmb_func_t approx;
+  fmb_func_t ref;
+  float lo;
+  float hi;
+  uint32_t flags;
+} fmb_entry_t;
+
+typedef struct fmb_result {
+  float max_err;   /**< Maximum absolute (or relative) error */
+  float max_at;    /**< Argument of the maximum error */
+  float rms_err;   /**< RMS of the absolute (or relative) error */
+  float ticks;     /**< Average ticks per call, 0 unless PROFILE_ENABLE is defined */
+} fmb_result_t;
+
+/** @} */
+
+/*===========================================================================*/
+/* Standard Suite.                                                           */
+/*===========================================================================*/
+
+/**
+ * @name    Standard Suite
+ * @{
+ */
+
+/** @private */
+static float fmb_identity(float x) { return x; }
+
+/** @private */
+static float fmb_pow2f(float x) { return powf(2.f, x); }
+
+/** @private */
+static float fmb_log2f(float x) { return logf(x) * M_LOG2E; }
+
+/** @private */
+static float fmb_ampdbf(float x) { return 20.f * log10f(x); }
+
+/** Approximations of float_math.h over their documented domains
+ * @note Float references from libm, themselves accurate to about 1 ulp.
+ * @note tier_* entries measure the tier selected by FLOAT_MATH_TIER at compile time.
+ */
+static const fmb_entry_t k_fmb_suite[] = {
+  { "fastsinf",       fastsinf,       sinf,       -M_PI,   M_PI,   0 },
+  { "fastersinf",     fastersinf,     sinf,       -M_PI,   M_PI,   0 },
+  { "fastsinfullf",   fastsinfullf,   sinf,       -100.f,  100.f,  0 },
+  { "fastersinfullf", fastersinfullf, sinf,       -100.f,  100.f,  0 },
+  { "fastcosf",       fastcosf,       cosf,       -M_PI,   M_PI,   0 },
+  { "fastercosf",     fastercosf,     cosf,       -M_PI,   M_PI,   0 },
+  { "fastlog2f",      fastlog2f,      fmb_log2f,  1e-3f,   1e3f,   0 },
+  { "fasterlog2f",    fasterlog2f,    fmb_log2f,  1e-3f,   1e3f,   0 },
+  { "fastpow2f",      fastpow2f,      fmb_pow2f,  -20.f,   20.f,   FMB_REL_ERROR },
+  { "fasterpow2f",    fasterpow2f,    fmb_pow2f,  -20.f,   20.f,   FMB_REL_ERROR },
+  { "fastexpf",       fastexpf,       expf,       -10.f,   10.f,   FMB_REL_ERROR },
+  { "fasterexpf",     fasterexpf,     expf,       -10.f,   10.f,   FMB_REL_ERROR },
+  { "fastertanhf",    fastertanhf,    tanhf,      0.f,     3.5f,   0 },
+  { "fasterdbampf",   fasterdbampf,   dbampf,     -96.f,   24.f,   FMB_REL_ERROR },
+  { "fasterampdbf",   fasterampdbf,   fmb_ampdbf, 1e-4f,   16.f,   0 },
+  { "tier_tanhf",     tier_tanhf,     tanhf,      -8.f,    8.f,    0 },
+  { "tier_dbampf",    tier_dbampf,    dbampf,     -96.f,   24.f,   FMB_REL_ERROR },
+  { "tier_ampdbf",    tier_ampdbf,    fmb_ampdbf, 1e-4f,   16.f,   0 },
+};
+
+#define FMB_SUITE_SIZE (sizeof(k_fmb_suite) / sizeof(k_fmb_suite[0]))
+
+/** @} */
+
+/*===========================================================================*/
+/* Functions.                                                                */
+/*===========================================================================*/
+
+/**
+ * @name    Functions
+ * @{
+ */
+
+/** Average ticks per call of f over n points of [lo, hi]
+ */
+static inline float fmb_cost(fmb_func_t f, float lo, float hi, uint32_t n) {
+#if defined(PROFILE_ENABLE)
+  volatile float sink = 0.f;
+  const float dx = (hi - lo) / n;
+  float x = lo;
+  float acc = 0.f;
+  const uint32_t t0 = profile_now();
+  for (uint32_t i = 0; i < n; ++i, x += dx)
+    acc += f(x);
+  const uint32_t t1 = profile_now();
+  sink = acc;
+  (void)sink;
+  return (float)(t1 - t0) / n;
+#else
+  (void)f; (void)lo; (void)hi; (void)n;
+  return 0.f;
+#endif
+}
+
+/** Measure one entry over n evenly spaced points of its domain
+ */
+static inline void fmb_measure(const fmb_entry_t *e, uint32_t n, fmb_result_t *res) {
+  const float dx = (e->hi - e->lo) / (n - 1);
+  float max_err = 0.f;
+  float max_at = e->lo;
+  float sum_sq = 0.f;
+  for (uint32_t i = 0; i < n; ++i) {
+    const float x = e->lo + i * dx;
+    const float r = e->ref(x);
+    float err = si_fabsf(e->approx(x) - r);
+    if ((e->flags & FMB_REL_ERROR) && r != 0.f)
+      err /= si_fabsf(r);
+    sum_sq += err * err;
+    if (err > max_err) {
+      max_err = err;
+      max_at = x;
+    }
+  }
+  res->max_err = max_err;
+  res->max_at = max_at;
+  res->rms_err = sqrtf(sum_sq / n);
+
+  const float base = fmb_cost(fmb_identity, e->lo, e->hi, n);
+  const float cost = fmb_cost(e->approx, e->lo, e->hi, n) - base;
+  res->ticks = (cost > 0.f) ? cost : 0.f;
+}
+
+/** Measure the standard suite, results must hold FMB_SUITE_SIZE entries
+ */
+static inline void fmb_run_suite(fmb_result_t *results, uint32_t n) {
+  for (uint32_t i = 0; i < FMB_SUITE_SIZE; ++i)
+    fmb_measure(&k_fmb_suite[i], n, &results[i]);
+}
+
+#if !defined(__ARM_ARCH_7EM__)
+/** Print results of the standard suite, e.g.: from a host harness
+ */
+static inline void fmb_dump(FILE *out, const fmb_result_t *results) {
+  fprintf(out, "%-16s %12s %12s %12s %10s\n", "function", "max err", "at", "rms err", "ticks");
+  for (uint32_t i = 0; i < FMB_SUITE_SIZE; ++i)
+    fprintf(out, "%-16s %12.3e %12.4g %12.3e %10.2f\n", k_fmb_suite[i].name, results[i].max_err,
+            results[i].max_at, results[i].rms_err, results[i].ticks);
+}
+#endif
+
+/** @} */
+
+#endif // __float_math_bench_h
+
+/** @} @} */
@@ -0,0 +1,273 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    profile.h
+ * @brief   Lightweight hot path profiling.
+ *
+ * @addtogroup utils Utils
+ * @{
+ *
+ * @addtogroup utils_profile Profiling
+ * @{
+ *
+ */
+
+#ifndef __profile_h
+#define __profile_h
+
+#include <stdint.h>
+
+/**
+ * @name    Configuration
+ *
+ * Profiling is compiled out unless PROFILE_ENABLE is defined, e.g.: UDEFS = -DPROFILE_ENABLE
+ *
+ * The profiling table is shared by all translation units, and must be defined in exactly
+ * one of them by defining PROFILE_IMPLEMENTATION before including this header. On drumlogue,
+ * common/_unit_base.c already does so.
+ * @{
+ */
+
+#ifndef PROFILE_MAX_SECTIONS
+/** Number of sections in the profiling table */
+#define PROFILE_MAX_SECTIONS 8
+#endif
+
+/** @} */
+
+#if defined(PROFILE_ENABLE)
+
+#if defined(__ARM_ARCH_7EM__)
+/* Cortex-M4: DWT cycle counter */
+#define PROFILE_DEMCR       (*(volatile uint32_t *)0xE000EDFCU)
+#define PROFILE_DWT_CTRL    (*(volatile uint32_t *)0xE0001000U)
+#define PROFILE_DWT_CYCCNT  (*(volatile uint32_t *)0xE0001004U)
+#else
+/* drumlogue and host builds: monotonic clock */
+#include <time.h>
+#endif
+
+#if !defined(__ARM_ARCH_7EM__)
+#include <stdio.h>
+#endif
+
+/*===========================================================================*/
+/* Types.                                                                    */
+/*===========================================================================*/
+
+/**
+ * @name    Types
+ * @{
+ */
+
+/** Aggregated timing of a profiled section. Ticks are CPU cycles on Cortex-M4, nanoseconds otherwise */
+typedef struct {
+  const char *name;
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+} profile_section_t;
+
+/** Statistics that can be queried with profile_value() */
+enum {
+  k_profile_stat_min = 0,
+  k_profile_stat_avg,
+  k_profile_stat_max,
+  k_profile_stat_count
+};
+
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @private */
+extern profile_section_t profile_sections[PROFILE_MAX_SECTIONS];
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(PROFILE_IMPLEMENTATION)
+profile_section_t profile_sections[PROFILE_MAX_SECTIONS];
+#endif
+
+/*===========================================================================*/
+/* Functions.                                                                */
+/*===========================================================================*/
+
+/**
+ * @name    Functions
+ * @{
+ */
+
+/** Reset profiling table and start tick counter
+ */
+static inline void profile_init(void) {
+#if defined(__ARM_ARCH_7EM__)
+  PROFILE_DEMCR |= (1U<<24);    // TRCENA
+  PROFILE_DWT_CYCCNT = 0;
+  PROFILE_DWT_CTRL |= 1U;       // CYCCNTENA
+#endif
+  for (uint32_t i = 0; i < PROFILE_MAX_SECTIONS; ++i) {
+    profile_sections[i].count = 0;
+    profile_sections[i].min = 0xFFFFFFFFU;
+    profile_sections[i].max = 0;
+    profile_sections[i].total = 0;
+  }
+}
+
+/** Current tick count, wraps around
+ */
+static inline __attribute__((always_inline))
+uint32_t profile_now(void) {
+#if defined(__ARM_ARCH_7EM__)
+  return PROFILE_DWT_CYCCNT;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000U + (uint32_t)ts.tv_nsec;
+#endif
+}
+
+/** Record elapsed ticks for a section
+ *
+ * @param idx Section index, less than PROFILE_MAX_SECTIONS
+ * @param name Section name, must be a string literal or otherwise persistent
+ * @param ticks Elapsed ticks
+ */
+static inline __attribute__((always_inline))
+void profile_record(uint32_t idx, const char *name, uint32_t ticks) {
+  profile_section_t *s = &profile_sections[idx];
+  s->name = name;
+  s->count++;
+  s->total += ticks;
+  if (ticks < s->min)
+    s->min = ticks;
+  if (ticks > s->max)
+    s->max = ticks;
+}
+
+/** Get a statistic of a section, e.g.: to expose it as a read-only parameter value
+ *
+ * @param idx Section index
+ * @param stat One of k_profile_stat_min, k_profile_stat_avg, k_profile_stat_max or k_profile_stat_count
+ * @return Statistic value, saturated to int32_t range
+ */
+static inline int32_t profile_value(uint32_t idx, uint32_t stat) {
+  const profile_section_t *s = &profile_sections[idx];
+  uint64_t v = 0;
+  if (s->count) {
+    switch (stat) {
+    case k_profile_stat_min: v = s->min; break;
+    case k_profile_stat_avg: v = s->total / s->count; break;
+    case k_profile_stat_max: v = s->max; break;
+    default: v = s->count; break;
+    }
+  }
+  return (v > 0x7FFFFFFFU) ? 0x7FFFFFFF : (int32_t)v;
+}
+
+#if !defined(__ARM_ARCH_7EM__)
+/** Print profiling table, e.g.: from a host harness or on drumlogue teardown
+ */
+static inline void profile_dump(FILE *out) {
+  fprintf(out, "%-16s %10s %10s %10s %10s\n", "section", "count", "min", "avg", "max");
+  for (uint32_t i = 0; i < PROFILE_MAX_SECTIONS; ++i) {
+    const profile_section_t *s = &profile_sections[i];
+    if (!s->count)
+      continue;
+    fprintf(out, "%-16s %10u %10u %10u %10u\n", s->name, (unsigned)s->count, (unsigned)s->min,
+            (unsigned)(s->total / s->count), (unsigned)s->max);
+  }
+}
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/* Markers.                                                                  */
+/*===========================================================================*/
+
+/**
+ * @name    Markers
+ * @{
+ */
+
+/** Start timing a section, declaring a local variable holding the start tick */
+#define PROFILE_BEGIN(var) const uint32_t var = profile_now()
+
+/** End timing a section started with PROFILE_BEGIN() */
+#define PROFILE_END(idx, name, var) profile_record((idx), (name), profile_now() - (var))
+
+#ifdef __cplusplus
+
+/** @private */
+struct ProfileScope {
+  ProfileScope(uint32_t idx, const char *name) :
+    mIdx(idx), mName(name), mStart(profile_now())
+  { }
+
+  ~ProfileScope(void) {
+    profile_record(mIdx, mName, profile_now() - mStart);
+  }
+
+  uint32_t mIdx;
+  const char *mName;
+  uint32_t mStart;
+};
+
+/** Time the enclosing scope, e.g.: PROFILE_SCOPE(0, "filter"); */
+#define PROFILE_SCOPE(idx, name) const ProfileScope _profile_scope_##idx((idx), (name))
+
+#endif
+
+/** @} */
+
+#else  // !PROFILE_ENABLE
+
+#define profile_init()
+#define profile_value(idx, stat) (0)
+#define profile_dump(out)
+#define PROFILE_BEGIN(var)
+#define PROFILE_END(idx, name, var)
+#define PROFILE_SCOPE(idx, name)
+
+#endif // PROFILE_ENABLE
+
+#endif // __profile_h
+
+/** @} @} */
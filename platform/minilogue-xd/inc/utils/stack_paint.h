@@ -0,0 +1,206 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    stack_paint.h
+ * @brief   Stack usage measurement by stack painting.
+ *
+ * @addtogroup utils Utils
+ * @{
+ *
+ * @addtogroup utils_stack_paint Stack Painting
+ * @{
+ *
+ */
+
+#ifndef __stack_paint_h
+#define __stack_paint_h
+
+#include <stdint.h>
+
+/*===========================================================================*/
+/* Constants.                                                                */
+/*===========================================================================*/
+
+/**
+ * @name    Constants
+ * @{
+ */
+
+/** Pattern written to unused stack */
+#define STACK_PAINT_PATTERN 0xA5A5A5A5U
+
+#ifndef USER_STACK_PAINT_SIZE
+/** Bytes painted below the stack pointer, must not exceed stack space actually available to user code */
+#define USER_STACK_PAINT_SIZE 1024U
+#endif
+
+/** @} */
+
+/*===========================================================================*/
+/* Types.                                                                    */
+/*===========================================================================*/
+
+/**
+ * @name    Types
+ * @{
+ */
+
+/** Stack usage of a measured call site */
+typedef struct {
+  uintptr_t sp;         ///< Stack pointer at last measurement
+  uint32_t last_depth;  ///< Depth in bytes used by last call
+  uint32_t max_depth;   ///< Worst case depth in bytes, equal to painted size if region was exhausted
+} stack_usage_t;
+
+/** @} */
+
+/*===========================================================================*/
+/* Functions.                                                                */
+/*===========================================================================*/
+
+/**
+ * @name    Functions
+ *
+ * These must be inlined into the measuring function so that painting does not itself
+ * use stack below the current stack pointer.
+ * @{
+ */
+
+/** Current stack pointer
+ */
+static inline __attribute__((always_inline))
+uintptr_t stack_pointer(void) {
+  uintptr_t sp;
+#if defined(__arm__) || defined(__aarch64__)
+  __asm__ volatile ("mov %0, sp" : "=r" (sp));
+#elif defined(__x86_64__)
+  __asm__ volatile ("mov %%rsp, %0" : "=r" (sp));
+#elif defined(__i386__)
+  __asm__ volatile ("mov %%esp, %0" : "=r" (sp));
+#else
+  sp = (uintptr_t)__builtin_frame_address(0);
+#endif
+  return sp;
+}
+
+/** Paint stack below given stack pointer
+ *
+ * The whole region is painted on every call since other code sharing the stack may have
+ * used it in between, costing size / 4 stores.
+ */
+static inline __attribute__((always_inline))
+void stack_paint(stack_usage_t *usage, uintptr_t sp, uint32_t size) {
+  sp &= ~(uintptr_t)3;
+  volatile uint32_t *p = (volatile uint32_t *)(sp - (size & ~3U));
+  volatile uint32_t * const e = (volatile uint32_t *)sp;
+  for (; p != e; ++p)
+    *p = STACK_PAINT_PATTERN;
+  usage->sp = sp;
+}
+
+/** Measure stack used below given stack pointer since last paint
+ */
+static inline __attribute__((always_inline))
+void stack_measure(stack_usage_t *usage, uintptr_t sp, uint32_t size) {
+  sp &= ~(uintptr_t)3;
+  volatile const uint32_t *p = (volatile const uint32_t *)(sp - (size & ~3U));
+  volatile const uint32_t * const e = (volatile const uint32_t *)sp;
+  for (; p != e && *p == STACK_PAINT_PATTERN; ++p) ;
+  const uint32_t depth = (uint32_t)((uintptr_t)e - (uintptr_t)p);
+  usage->last_depth = depth;
+  if (depth > usage->max_depth)
+    usage->max_depth = depth;
+}
+
+/** Measure stack used by a call expression, e.g.: from a host test harness
+ *
+ * @code
+ * static stack_usage_t s_cycle_stack;
+ * STACK_PAINT_CALL(&s_cycle_stack, 4096, _hook_cycle(&params, buf, 64));
+ * printf("OSC_CYCLE used %u bytes\n", s_cycle_stack.max_depth);
+ * @endcode
+ */
+#define STACK_PAINT_CALL(usage, size, call)             \
+  do {                                                  \
+    const uintptr_t _stack_sp = stack_pointer();        \
+    stack_paint((usage), _stack_sp, (size));            \
+    call;                                               \
+    stack_measure((usage), _stack_sp, (size));          \
+  } while (0)
+
+/** @} */
+
+/*===========================================================================*/
+/* User Module Hooks.                                                        */
+/*===========================================================================*/
+
+/**
+ * @name    User module hooks
+ *
+ * When USER_STACK_PAINT is defined (e.g.: UDEFS = -DUSER_STACK_PAINT), the unit entry
+ * template measures stack usage of the initialization, render (cycle or process) and
+ * parameter hooks, which can be queried with _stack_max_depth().
+ * @{
+ */
+
+enum {
+  k_user_stack_hook_init = 0U,
+  k_user_stack_hook_render,
+  k_user_stack_hook_param,
+  k_num_user_stack_hooks
+};
+
+#if defined(USER_STACK_PAINT)
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /**
+   * Worst case stack depth observed for a hook
+   *
+   * @param hook One of k_user_stack_hook_init, k_user_stack_hook_render or k_user_stack_hook_param
+   * @return Depth in bytes, equal to USER_STACK_PAINT_SIZE if painted region was exhausted
+   */
+  uint32_t _stack_max_depth(uint32_t hook);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/** @} */
+
+#endif // __stack_paint_h
+
+/** @} @} */
@@ -43,71 +43,126 @@
 
 static Waves s_waves;
 
+// Minimum phase band-limited step minus ideal step, over k_minblep_taps samples
+// with k_minblep_phases points per sample, plus guard point.
+static const float s_minblep_residual[Waves::k_minblep_size + 1] = {
+  -1.00000000e+00f, -9.99998599e-01f, -9.99994934e-01f, -9.99986019e-01f, -9.99967356e-01f, -9.99932091e-01f, -9.99870292e-01f, -9.99768122e-01f,
+  -9.99606934e-01f, -9.99362282e-01f, -9.99002894e-01f, -9.98489622e-01f, -9.97774411e-01f, -9.96799315e-01f, -9.95495630e-01f, -9.93783172e-01f,
+  -9.91569767e-01f, -9.88750990e-01f, -9.85210224e-01f, -9.80819070e-01f, -9.75438159e-01f, -9.68918412e-01f, -9.61102743e-01f, -9.51828250e-01f,
+  -9.40928870e-01f, -9.28238493e-01f, -9.13594506e-01f, -8.96841703e-01f, -8.77836512e-01f, -8.56451436e-01f, -8.32579625e-01f, -8.06139452e-01f,
+  -7.77078977e-01f, -7.45380164e-01f, -7.11062704e-01f, -6.74187321e-01f, -6.34858413e-01f, -5.93225903e-01f, -5.49486184e-01f, -5.03882070e-01f,
+  -4.56701660e-01f, -4.08276084e-01f, -3.58976091e-01f, -3.09207504e-01f, -2.59405572e-01f, -2.10028304e-01f, -1.61548893e-01f, -1.14447370e-01f,
+  -6.92016608e-02f, -2.62782411e-02f, 1.38773917e-02f, 5.08501929e-02f, 8.42647523e-02f, 1.13793934e-01f, 1.39166737e-01f, 1.60175135e-01f,
+  1.76679708e-01f, 1.88613854e-01f, 1.95986453e-01f, 1.98882862e-01f, 1.97464159e-01f, 1.91964634e-01f, 1.82687532e-01f, 1.69999128e-01f,
+  1.54321258e-01f, 1.36122462e-01f, 1.15907957e-01f, 9.42086693e-02f, 7.15696193e-02f, 4.85379320e-02f, 2.56507988e-02f, 3.42369367e-03f,
+  -1.76608414e-02f, -3.71635479e-02f, -5.46976660e-02f, -6.99367721e-02f, -8.26210330e-02f, -9.25617176e-02f, -9.96438549e-02f, -1.03826981e-01f,
+  -1.05143971e-01f, -1.03698012e-01f, -9.96578108e-02f, -9.32512054e-02f, -8.47573603e-02f, -7.44977998e-02f, -6.28265381e-02f, -5.01195999e-02f,
+  -3.67642355e-02f, -2.31481397e-02f, -9.64897927e-03f, 3.37548253e-03f, 1.55963967e-02f, 2.67217406e-02f, 3.65029318e-02f, 4.47399896e-02f,
+  5.12851343e-02f, 5.60447681e-02f, 5.89798279e-02f, 6.01045527e-02f, 5.94837503e-02f, 5.72286985e-02f, 5.34918465e-02f, 4.84605200e-02f,
+  4.23498551e-02f, 3.53952016e-02f, 2.78442466e-02f, 1.99491093e-02f, 1.19586505e-02f, 4.11122372e-03f, -3.37192645e-03f, -1.02924422e-02f,
+  -1.64796609e-02f, -2.17943453e-02f, -2.61312679e-02f, -2.94206168e-02f, -3.16282351e-02f, -3.27547380e-02f, -3.28335869e-02f, -3.19282339e-02f,
+  -3.01284701e-02f, -2.75461367e-02f, -2.43103651e-02f, -2.05625263e-02f, -1.64510648e-02f, -1.21263937e-02f, -7.73601327e-03f, -3.42000056e-03f,
+  6.93001450e-04f, 4.48919102e-03f, 7.87233062e-03f, 1.07657339e-02f, 1.31134923e-02f, 1.48809445e-02f, 1.60544158e-02f, 1.66402797e-02f,
+  1.66634121e-02f, 1.61651275e-02f, 1.52006990e-02f, 1.38365720e-02f, 1.21473841e-02f, 1.02129072e-02f, 8.11501953e-03f, 5.93481300e-03f,
+  3.74992450e-03f, 1.63217077e-03f, -3.54452405e-04f, -2.15536036e-03f, -3.72653115e-03f, -5.03520785e-03f, -6.06015803e-03f, -6.79151255e-03f,
+  -7.23021860e-03f, -7.38715305e-03f, -7.28195267e-03f, -6.94162384e-03f, -6.39899810e-03f, -5.69110066e-03f, -4.85749678e-03f, -3.93867791e-03f,
+  -2.97454355e-03f, -2.00302718e-03f, -1.05890601e-03f, -1.72822735e-04f, 6.29460730e-04f, 1.32756813e-03f, 1.90677255e-03f, 2.35802931e-03f,
+  2.67779527e-03f, 2.86765968e-03f, 2.93381553e-03f, 2.88640463e-03f, 2.73877234e-03f, 2.50666808e-03f, 2.20742773e-03f, 1.85916975e-03f,
+  1.48003454e-03f, 1.08749296e-03f, 6.97745159e-04f, 3.25224924e-04f, -1.77805387e-05f, -3.21391533e-04f, -5.78278062e-04f, -7.83688413e-04f,
+  -9.35373473e-04f, -1.03341942e-03f, -1.08000513e-03f, -1.07910049e-03f, -1.03612290e-03f, -9.57569785e-04f, -8.50644927e-04f, -7.22894195e-04f,
+  -5.81864716e-04f, -4.34798665e-04f, -2.88370473e-04f, -1.48474520e-04f, -2.00671034e-05f, 9.29355102e-05f, 1.87705647e-04f, 2.62503223e-04f,
+  3.16629041e-04f, 3.50339497e-04f, 3.64729525e-04f, 3.61592581e-04f, 3.43265684e-04f, 3.12467849e-04f, 2.72139103e-04f, 2.25286882e-04f,
+  1.74846083e-04f, 1.23557861e-04f, 7.38700574e-05f, 2.78598683e-05f, -1.28187782e-05f, -4.69632326e-05f, -7.38267439e-05f, -9.31014316e-05f,
+  -1.04883543e-04f, -1.09623765e-04f, -1.08066129e-04f, -1.01178702e-04f, -9.00792789e-05f, -7.59621228e-05f, -6.00285537e-05f, -4.34235631e-05f,
+  -2.71810578e-05f, -1.21801640e-05f, 8.86580999e-07f, 1.15321284e-05f, 1.94810385e-05f, 2.46634644e-05f, 2.71973730e-05f, 2.73604443e-05f,
+  2.55523909e-05f, 2.22528863e-05f, 1.79797099e-05f, 1.32471077e-05f, 8.52743859e-06f, 4.21863856e-06f, 6.19208963e-07f, -2.08582323e-06f,
+  -3.82814378e-06f, -4.64791978e-06f, -4.67672348e-06f, -4.11394849e-06f, -3.19438544e-06f, -2.15255610e-06f, -1.19089613e-06f, -4.52669803e-07f,
+  -3.88273458e-09f, 1.70749952e-07f, 1.53525165e-07f, 6.05547603e-08f, -5.63576041e-09f, -7.13635784e-09f, 8.99075303e-09f, 5.89749827e-09f,
+  0.00000000e+00f
+};
+
+__fast_inline float minblep_residual(const float t) {
+  const float idxf = t * Waves::k_minblep_phases;
+  const uint32_t idx = (uint32_t)idxf;
+  return linintf(idxf - idx, s_minblep_residual[idx], s_minblep_residual[idx+1]);
+}
+
 void OSC_INIT(uint32_t platform, uint32_t api)
 {
   (void)platform;
   (void)api;
 }
 
-void OSC_CYCLE(const user_osc_param_t * const params,
-               int32_t *yn,
-               const uint32_t frames)
+enum {
+  k_morph_off = 0,
+  k_morph_static,
+  k_morph_moving
+};
+
+template <bool sync, uint32_t morph>
+__fast_inline void render(q31_t * __restrict y, const uint32_t frames)
 {
-  
   Waves::State &s = s_waves.state;
   const Waves::Params &p = s_waves.params;
 
-  // Handle events.
-  {
-    const uint32_t flags = s.flags;
-    s.flags = Waves::k_flags_none;
-    
-    s_waves.updatePitch(osc_w0f_for_note((params->pitch)>>8, params->pitch & 0xFF));
-    
-    s_waves.updateWaves(flags);
-    
-    if (flags & Waves::k_flag_reset)
-      s.reset();
-    
-    s.lfo = q31_to_f32(params->shape_lfo);
-
-    if (flags & Waves::k_flag_bitcrush) {
-      s.dither = p.bitcrush * 2e-008f;
-      s.bitres = osc_bitresf(p.bitcrush);
-      s.bitresrcp = 1.f / s.bitres;
-    }
-  }
-  
   // Temporaries.
-  float phi0 = s.phi0;
-  float phi1 = s.phi1;
-  float phisub = s.phisub;
+  dsp::Phasor phi0 = s.phi0;
+  dsp::Phasor phi1 = s.phi1;
+  dsp::Phasor phisub = s.phisub;
 
   float lfoz = s.lfoz;
   const float lfo_inc = (s.lfo - lfoz) / frames;
   
-  const float ditheramt = p.bitcrush * 2e-008f;
-  
-  const float bitres = osc_bitresf(p.bitcrush);
-  const float bitres_recip = 1.f / bitres;
-
   const float submix = p.submix;
   const float ringmix = p.ringmix;
   
   dsp::BiQuad &prelpf = s_waves.prelpf;
   dsp::BiQuad &postlpf = s_waves.postlpf;
+
+  float * const blep = s.blep;
+  uint32_t blepidx = s.blepidx;
+  uint32_t bleppending = s.bleppending;
+  const float w0recip = (sync) ? 1.f / phi0.w0 : 0.f;
+
+  uint32_t morphidx = Waves::k_bank_cnt;
+  const float *morph0 = s.morphframe;
+  const float *morph1 = s.morphframe;
   
-  q31_t * __restrict y = (q31_t *)yn;
   const q31_t * y_e = y + frames;
   
   for (; y != y_e; ) {
 
-    const float wavemix = clipminmaxf(0.005f, p.shape+lfoz, 0.995f);
+    float sig;
+    if (morph == k_morph_static) {
+      sig = phi0.lookup<k_waves_size_exp>(s.morphframe);
+    }
+    else if (morph == k_morph_moving) {
+      const float pos = clip01f(p.shape+lfoz) * (Waves::k_bank_cnt - 1);
+      const uint32_t idx = (uint32_t)pos;
+      if (idx != morphidx) {
+        morphidx = idx;
+        morph0 = Waves::bankWave(idx);
+        morph1 = Waves::bankWave(clipmaxu32(idx + 1, Waves::k_bank_cnt - 1));
+      }
+      sig = linintf(pos - idx,
+                    phi0.lookup<k_waves_size_exp>(morph0),
+                    phi0.lookup<k_waves_size_exp>(morph1));
+    }
+    else {
+      const float wavemix = clipminmaxf(0.005f, p.shape+lfoz, 0.995f);
     
-    float sig = (1.f - wavemix) * osc_wave_scanf(s.wave0, phi0);
-    sig += wavemix * osc_wave_scanf(s.wave1, phi1);
+      float sig1 = phi1.lookup<k_waves_size_exp>(s.wave1);
+      if (sync) {
+        sig1 += blep[blepidx];
+        blep[blepidx] = 0.f;
+        blepidx = (blepidx + 1) & Waves::k_minblep_taps_mask;
+      }
+
+      sig = (1.f - wavemix) * phi0.lookup<k_waves_size_exp>(s.wave0);
+      sig += wavemix * sig1;
+    }
     
-    const float subsig = osc_wave_scanf(s.subwave, phisub);
+    const float subsig = phisub.lookup<k_waves_size_exp>(s.subwave);
     sig = (1.f - submix) * sig + submix * subsig;
     sig = (1.f - ringmix) * sig + ringmix * (subsig * sig);
     sig = clip1m1f(sig);
@@ -120,12 +175,29 @@ void OSC_CYCLE(const user_osc_param_t * const params,
     
     *(y++) = f32_to_q31(sig);
     
-    phi0 += s.w00;
-    phi0 -= (uint32_t)phi0;
-    phi1 += s.w01;
-    phi1 -= (uint32_t)phi1;
-    phisub += s.w0sub;
-    phisub -= (uint32_t)phisub;
+    bool reset = false;
+    if (sync)
+      reset = phi0.cycleWrap() && p.sync;
+    else
+      phi0.cycle();
+
+    if (reset) {
+      // Master wrapped between this sample and the next, reset wave1 at the exact
+      // crossing and spread the step over the following samples.
+      const float d = phi0.phi * w0recip;
+      dsp::Phasor pre = phi1;
+      pre.phi += (uq32_t)(phi1.w0 * (1.f - d));
+      const dsp::Phasor post;
+      const float h = post.lookup<k_waves_size_exp>(s.wave1) - pre.lookup<k_waves_size_exp>(s.wave1);
+      for (uint32_t i = 0; i < Waves::k_minblep_taps; ++i)
+        blep[(blepidx + i) & Waves::k_minblep_taps_mask] += h * minblep_residual(d + i);
+      bleppending = frames - (y_e - y) + Waves::k_minblep_taps;
+      phi1.sync(phi0.phi, s.syncratio);
+    }
+    else {
+      phi1.cycle();
+    }
+    phisub.cycle();
     lfoz += lfo_inc;
   }
   
@@ -133,6 +205,64 @@ void OSC_CYCLE(const user_osc_param_t * const params,
   s.phi1 = phi1;
   s.phisub = phisub;
   s.lfoz = lfoz;
+  s.blepidx = blepidx;
+  s.bleppending = (bleppending > frames) ? bleppending - frames : 0;
+}
+
+void OSC_CYCLE(const user_osc_param_t * const params,
+               int32_t *yn,
+               const uint32_t frames)
+{
+  
+  Waves::State &s = s_waves.state;
+  const Waves::Params &p = s_waves.params;
+
+  // Handle events.
+  {
+    const uint32_t flags = s.flags;
+    s.flags = Waves::k_flags_none;
+    
+    s_waves.updatePitch(osc_w0f_for_note((params->pitch)>>8, params->pitch & 0xFF));
+    
+    s_waves.updateWaves(flags);
+    
+    if (flags & Waves::k_flag_reset)
+      s.reset();
+    
+    s.lfo = q31_to_f32(params->shape_lfo);
+
+    if (flags & Waves::k_flag_bitcrush) {
+      s.dither = p.bitcrush * 2e-008f;
+      s.bitres = osc_bitresf(p.bitcrush);
+      s.bitresrcp = 1.f / s.bitres;
+    }
+  }
+
+  if (p.morph) {
+    if (s.bleppending)
+      s.flushSync();
+    
+    // Reuse the blended frame as long as neither shape nor its LFO move the
+    // morph position during this block.
+    const float pos = clip01f(p.shape + s.lfoz) * (Waves::k_bank_cnt - 1);
+    if (pos == clip01f(p.shape + s.lfo) * (Waves::k_bank_cnt - 1)) {
+      if (pos != s.morphpos)
+        s_waves.updateMorphFrame(pos);
+      render<false, k_morph_static>((q31_t *)yn, frames);
+    }
+    else {
+      render<false, k_morph_moving>((q31_t *)yn, frames);
+    }
+    return;
+  }
+
+  // Only pay for sync correction if the master wraps within this block,
+  // or if residuals from a previous sync event are still being applied.
+  const bool wraps = ((uint64_t)s.phi0.phi + (uint64_t)s.phi0.w0 * frames) > 0xFFFFFFFFULL;
+  if ((p.sync && wraps) || s.bleppending)
+    render<true, k_morph_off>((q31_t *)yn, frames);
+  else
+    render<false, k_morph_off>((q31_t *)yn, frames);
 }
 
 void OSC_NOTEON(const user_osc_param_t * const params)
@@ -154,9 +284,11 @@ void OSC_PARAM(uint16_t index, uint16_t value)
   case k_user_osc_param_id1:
     // wave 0
     // select parameter
+    // second half of range morphs through all waves with shape instead
     {
       static const uint8_t cnt = k_waves_a_cnt + k_waves_b_cnt + k_waves_c_cnt; 
       p.wave0 = value % cnt;
+      p.morph = (value / cnt) & 1;
       s.flags |= Waves::k_flag_wave0;
     }
     break;
@@ -164,9 +296,11 @@ void OSC_PARAM(uint16_t index, uint16_t value)
   case k_user_osc_param_id2:
     // wave 1
     // select parameter
+    // second half of range selects the same waves hard synced to wave 0
     {
       static const uint8_t cnt = k_waves_d_cnt + k_waves_e_cnt + k_waves_f_cnt; 
       p.wave1 = value % cnt;
+      p.sync = (value / cnt) & 1;
       s.flags |= Waves::k_flag_wave1;
     }
     break;
@@ -41,6 +41,10 @@
 
 #include "userrevfx.h"
 
+#if defined(USER_STACK_PAINT)
+#include "stack_paint.h"
+#endif
+
 /*===========================================================================*/
 /* Externs and Types.                                                        */
 /*===========================================================================*/
@@ -69,6 +73,11 @@ typedef void (*__init_fptr)(void);
  * @{
  */
 
+#if defined(USER_STACK_PAINT)
+static void _stack_hook_process(float *xn, uint32_t frames);
+static void _stack_hook_param(uint8_t index, int32_t value);
+#endif
+
 __attribute__((used, section(".hooks")))
 static const user_revfx_hook_table_t s_hook_table = {
   .magic = {'U','R','E','V'},
@@ -76,13 +85,25 @@ static const user_revfx_hook_table_t s_hook_table = {
   .platform = USER_TARGET_PLATFORM>>8,
   .reserved0 = {0},
   .func_entry = _entry,
+#if defined(USER_STACK_PAINT)
+  .func_process = _stack_hook_process,
+#else
   .func_process = _hook_process,
+#endif
   .func_suspend = _hook_suspend,
   .func_resume = _hook_resume,
+#if defined(USER_STACK_PAINT)
+  .func_param = _stack_hook_param,
+#else
   .func_param = _hook_param,
+#endif
   .reserved1 = {0}
 };
 
+#if defined(USER_STACK_PAINT)
+static stack_usage_t s_stack_usage[k_num_user_stack_hooks];
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -113,7 +134,12 @@ void _entry(uint32_t platform, uint32_t api)
   }
   
   // Call user initialization
+#if defined(USER_STACK_PAINT)
+  STACK_PAINT_CALL(&s_stack_usage[k_user_stack_hook_init], USER_STACK_PAINT_SIZE,
+                   _hook_init(platform, api));
+#else
   _hook_init(platform, api);
+#endif
 }
 
 __attribute__((weak))
@@ -152,5 +178,37 @@ void _hook_param(uint8_t index, int32_t value)
 /** @} */
 
 
+/*===========================================================================*/
+/* Stack Painting Hooks.                                                     */
+/*===========================================================================*/
+
+/**
+ * @name   Stack Painting Hooks.
+ * @{
+ */
+
+#if defined(USER_STACK_PAINT)
+
+static void _stack_hook_process(float *xn, uint32_t frames)
+{
+  STACK_PAINT_CALL(&s_stack_usage[k_user_stack_hook_render], USER_STACK_PAINT_SIZE,
+                   _hook_process(xn, frames));
+}
+
+static void _stack_hook_param(uint8_t index, int32_t value)
+{
+  STACK_PAINT_CALL(&s_stack_usage[k_user_stack_hook_param], USER_STACK_PAINT_SIZE,
+                   _hook_param(index, value));
+}
+
+uint32_t _stack_max_depth(uint32_t hook)
+{
+  return (hook < k_num_user_stack_hooks) ? s_stack_usage[hook].max_depth : 0;
+}
+
+#endif
+
+/** @} */
+
 /** @} */
 
@@ -0,0 +1,290 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    phaser.hpp
+ * @brief   Allpass cascade and phaser.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include "float_math.h"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Cascade of N identical first order allpass stages.
+   *
+   * All stages share a single coefficient, computed as in BiQuad::Coeffs::setFOAP(), and
+   * the stage loop is fully unrolled with states kept in locals for the duration of a
+   * block. Coefficient changes are ramped linearly across a block.
+   *
+   * @tparam N Number of stages
+   */
+  template <uint32_t N>
+  struct AllpassCascade {
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    AllpassCascade(void) :
+      mA(0.f)
+    {
+      flush();
+    }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Calculate coefficient from cutoff
+     *
+     * @param k tan(pi*wc), e.g.: fx_tanpif(wc)
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float coeff(const float k) {
+      return (k - 1.f) / (k + 1.f);
+    }
+
+    /**
+     * Set cutoff immediately
+     *
+     * @param k tan(pi*wc), e.g.: fx_tanpif(wc)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setCoeffs(const float k) {
+      mA = coeff(k);
+    }
+
+    /**
+     * Flush stage states
+     */
+    inline void flush(void) {
+      for (uint32_t i = 0; i < N; ++i)
+        mZ[i] = 0.f;
+    }
+
+    /**
+     * Process one sample through all stages with given coefficient
+     *
+     * @param z Stage states
+     * @param a Allpass coefficient
+     * @param x Input sample
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float tick(float * __restrict z, const float a, float x) {
+      for (uint32_t i = 0; i < N; ++i) {
+        const float y = a * x + z[i];
+        z[i] = x - a * y;
+        x = y;
+      }
+      return x;
+    }
+
+    /**
+     * Process one sample
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process(const float x) {
+      return tick(mZ, mA, x);
+    }
+
+    /**
+     * Process a block, ramping to a new cutoff
+     *
+     * @param xn Input buffer
+     * @param yn Output buffer, can be the same as input
+     * @param frames Number of samples
+     * @param k Cutoff to reach at end of block, as tan(pi*wc)
+     * @param stride Sample stride in buffers, e.g.: 2 for one channel of interleaved stereo
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float * xn, float * yn, const uint32_t frames, const float k, const uint32_t stride = 1) {
+      float z[N];
+      for (uint32_t i = 0; i < N; ++i)
+        z[i] = mZ[i];
+
+      float a = mA;
+      const float a_inc = (coeff(k) - a) / frames;
+      const float * xn_e = xn + frames * stride;
+      for (; xn != xn_e; xn += stride, yn += stride) {
+        a += a_inc;
+        *yn = tick(z, a, *xn);
+      }
+
+      mA = coeff(k);
+      for (uint32_t i = 0; i < N; ++i)
+        mZ[i] = z[i];
+    }
+
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    float mZ[N];
+    float mA;
+  };
+
+  /**
+   * Stereo phaser built on allpass cascades, with feedback.
+   *
+   * Cutoffs are supplied once per block, typically derived from a control rate
+   * SimpleLFO:
+   * @code
+   * s_lfo.cycle();   // with w0 scaled by block size
+   * const float wc = wmin * fasterpowf(wmax / wmin, s_lfo.sine_uni());
+   * s_phaser.process(main_xn, main_yn, frames, fx_tanpif(wc), fx_tanpif(wc));
+   * @endcode
+   *
+   * @tparam N Number of allpass stages per channel, e.g.: 4, 6, 8 or 12
+   */
+  template <uint32_t N>
+  struct Phaser {
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Phaser(void) :
+      mFeedback(0.f),
+      mDepth(1.f)
+    {
+      mFb[0] = mFb[1] = 0.f;
+    }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Flush states
+     */
+    inline void flush(void) {
+      mStages[0].flush();
+      mStages[1].flush();
+      mFb[0] = mFb[1] = 0.f;
+    }
+
+    /**
+     * Set feedback amount
+     *
+     * @param fb Feedback in (-1, 1), negative values move notches up
+     */
+    inline void setFeedback(const float fb) {
+      mFeedback = clipminmaxf(-0.95f, fb, 0.95f);
+    }
+
+    /**
+     * Set depth of notches
+     *
+     * @param depth Depth in [0, 1], wet gain is 0.5 * depth and dry gain 1 - 0.5 * depth,
+     *              so that gains sum to unity and depth 1 is an equal mix with deepest notches
+     */
+    inline void setDepth(const float depth) {
+      mDepth = clip01f(depth);
+    }
+
+    /**
+     * Process a block of interleaved stereo samples
+     *
+     * @param xn Input buffer
+     * @param yn Output buffer, can be the same as input
+     * @param frames Number of stereo frames
+     * @param k_l Left cutoff at end of block, as tan(pi*wc)
+     * @param k_r Right cutoff at end of block, as tan(pi*wc)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float * xn, float * yn, const uint32_t frames, const float k_l, const float k_r) {
+      processChannel(0, xn, yn, frames, k_l);
+      processChannel(1, xn + 1, yn + 1, frames, k_r);
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /** @private */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void processChannel(const uint32_t ch, const float * xn, float * yn, const uint32_t frames, const float k) {
+      AllpassCascade<N> &stages = mStages[ch];
+      float z[N];
+      for (uint32_t i = 0; i < N; ++i)
+        z[i] = stages.mZ[i];
+
+      float a = stages.mA;
+      const float a_end = AllpassCascade<N>::coeff(k);
+      const float a_inc = (a_end - a) / frames;
+      const float fb = mFeedback;
+      const float wet = 0.5f * mDepth;
+      const float dry = 1.f - wet;
+      float last = mFb[ch];
+
+      const float * xn_e = xn + 2 * frames;
+      for (; xn != xn_e; xn += 2, yn += 2) {
+        a += a_inc;
+        const float x = *xn;
+        last = AllpassCascade<N>::tick(z, a, x + fb * last);
+        *yn = dry * x + wet * last;
+      }
+
+      mFb[ch] = last;
+      stages.mA = a_end;
+      for (uint32_t i = 0; i < N; ++i)
+        stages.mZ[i] = z[i];
+    }
+
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    AllpassCascade<N> mStages[2];
+    float mFb[2];
+    float mFeedback;
+    float mDepth;
+  };
+}
+
+/** @} */
@@ -0,0 +1,257 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    phasor.hpp
+ * @brief   Fixed-point phase accumulators.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include "fixed_math.h"
+#include "float_math.h"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Unsigned 32-bit phase accumulator.
+   *
+   * Phase spans [0, 1) over the full uq32 range so that wrap around is implicit
+   * in the integer overflow, and table indexes/fractions are obtained by shifts.
+   */
+  struct Phasor {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Phasor(void) :
+      phi(0), w0(0)
+    { }
+
+    /**
+     * Constructor with initial phase increment
+     *
+     * @param w Phase increment in [0, 1) range
+     */
+    Phasor(const float w) :
+      phi(0), w0(f32_to_uq32(w))
+    { }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Step phase one sample forward
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void cycle(void)
+    {
+      phi += w0;
+    }
+
+    /**
+     * Step phase one sample forward and report wrap around
+     *
+     * @return True if phase wrapped around during this step
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    bool cycleWrap(void)
+    {
+      const uq32_t p = phi;
+      phi += w0;
+      return phi < p;
+    }
+
+    /**
+     * Step phase forward by a whole block
+     *
+     * @param frames Number of samples to advance by
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void cycle(const uint32_t frames)
+    {
+      phi += w0 * frames;
+    }
+
+    /**
+     * Render successive phase values for a block and step phase forward accordingly
+     *
+     * @param phases Destination buffer
+     * @param frames Number of samples to render
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(uq32_t * __restrict phases, const uint32_t frames)
+    {
+      uq32_t p = phi;
+      const uq32_t w = w0;
+      const uq32_t * phases_e = phases + frames;
+      for (; phases != phases_e; p += w) {
+        *(phases++) = p;
+      }
+      phi = p;
+    }
+
+    /**
+     * Reset phase
+     *
+     * @param phase Phase to reset to in uq32 format
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void reset(const uq32_t phase = 0)
+    {
+      phi = phase;
+    }
+
+    /**
+     * Hard sync phase, preserving the overshoot of the master phase past its wrap point.
+     *
+     * @param overshoot Master phase position after its wrap around, in uq32 format
+     * @param ratio Ratio of this phasor's increment over the master's
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void sync(const uq32_t overshoot, const float ratio)
+    {
+      phi = (uq32_t)(int64_t)(overshoot * ratio); // wraps like f32_to_uq32()
+    }
+
+    /**
+     * Set phase increment
+     *
+     * @param w Phase increment in [0, 1) range, i.e.: f0 / Fs, other values wrap around
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setW0(const float w)
+    {
+      w0 = f32_to_uq32(w);
+    }
+
+    /**
+     * Set phase increment from frequency
+     *
+     * @param f0 Frequency in Hz
+     * @param fsrecip Reciprocal of sampling frequency (1/Fs)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setF0(const float f0, const float fsrecip)
+    {
+      w0 = f32_to_uq32(f0 * fsrecip);
+    }
+
+    /**
+     * Get current phase as floating point
+     *
+     * @return Phase in [0, 1)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float phase(void) const
+    {
+      return uq32_to_f32(phi);
+    }
+
+    /**
+     * Get current phase as bipolar q31 value, as used by dsp::SimpleLFO
+     *
+     * @return Phase in q31 format, 0 at phase 0.5
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    q31_t phaseq31(void) const
+    {
+      return (q31_t)(phi ^ 0x80000000);
+    }
+
+    /**
+     * Get table index for current phase
+     *
+     * @tparam size_exp Table size as a power of two exponent
+     * @return Index in [0, 1<<size_exp)
+     */
+    template <uint32_t size_exp>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t index(void) const
+    {
+      return phi >> (32 - size_exp);
+    }
+
+    /**
+     * Get interpolation fraction between current table index and next
+     *
+     * @tparam size_exp Table size as a power of two exponent
+     * @return Fraction in [0, 1)
+     */
+    template <uint32_t size_exp>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float frac(void) const
+    {
+      return uq32_to_f32(phi << size_exp);
+    }
+
+    /**
+     * Linearly interpolated lookup of a single cycle table for current phase
+     *
+     * @tparam size_exp Table size as a power of two exponent
+     * @param lut Table with (1<<size_exp) entries, plus optional guard point
+     * @return Interpolated table value
+     */
+    template <uint32_t size_exp>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float lookup(const float *lut) const
+    {
+      const uint32_t x0 = index<size_exp>();
+      const uint32_t x1 = (x0 + 1) & ((1U<<size_exp)-1);
+      return linintf(frac<size_exp>(), lut[x0], lut[x1]);
+    }
+
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    uq32_t phi;
+    uq32_t w0;
+  };
+}
+
+/** @} */
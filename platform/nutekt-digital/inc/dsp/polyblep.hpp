@@ -0,0 +1,326 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    polyblep.hpp
+ * @brief   Table-free band-limited oscillators using polynomial step and ramp residuals.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include "fixed_math.h"
+#include "float_math.h"
+#include "phasor.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Band-limited saw, pulse and triangle oscillator with optional hard sync.
+   *
+   * Discontinuities in value (PolyBLEP) and slope (PolyBLAMP) are located with sub-sample
+   * accuracy from the fixed-point phase and corrected over the two samples around them,
+   * one before and one carried over to the next sample. No lookup tables are used, pulse
+   * width can be modulated continuously, and hard sync resets are corrected the same way
+   * as the waveform's own edges.
+   */
+  struct PolyBLEPOsc {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    /**
+     * Waveforms
+     */
+    enum Waveform {
+      k_waveform_saw = 0,
+      k_waveform_square,
+      k_waveform_triangle
+    };
+
+    /**
+     * Block-invariant parameters
+     */
+    typedef struct Params {
+      float dt;
+      float dt_recip;
+      float mdt_recip;
+      float ratio;
+      float pw;
+    } Params;
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    PolyBLEPOsc(void) :
+      mPhasor(), mMaster(), mCarry(0), mSync(false)
+    {
+      mParams.pw = 0.5f;
+      mParams.mdt_recip = 0.f;
+      setW0(440.f / 48000.f);
+    }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reset phases and pending corrections
+     */
+    inline void reset(void)
+    {
+      mPhasor.reset();
+      mMaster.reset();
+      mCarry = 0;
+    }
+
+    /**
+     * Set phase increment
+     *
+     * @param w Phase increment in [0, 0.5) range, i.e.: f0 / Fs
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setW0(const float w)
+    {
+      mPhasor.setW0(w);
+      mParams.dt = uq32_to_f32(mPhasor.w0);
+      mParams.dt_recip = 1.f / mParams.dt;
+      updateSyncRatio();
+    }
+
+    /**
+     * Set pulse width of square waveform
+     *
+     * @param pw Pulse width in (0, 1), 0.5 for a symmetric square
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setPulseWidth(const float pw)
+    {
+      mParams.pw = clipminmaxf(0.01f, pw, 0.99f);
+    }
+
+    /**
+     * Enable hard sync to an internal master phasor
+     *
+     * @param w Master phase increment in (0, 0.5) range, 0 disables sync
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setSyncW0(const float w)
+    {
+      mMaster.setW0(w);
+      mSync = (mMaster.w0 != 0);
+      mParams.mdt_recip = (mSync) ? 1.f / uq32_to_f32(mMaster.w0) : 0.f;
+      updateSyncRatio();
+    }
+
+    /**
+     * Render next sample
+     *
+     * @tparam wave Waveform
+     * @return Output sample in [-1, 1] range, approximately
+     */
+    template <Waveform wave>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process(void)
+    {
+      return (mSync) ?
+        step<wave, true>(mPhasor, mMaster, mParams, mCarry) :
+        step<wave, false>(mPhasor, mMaster, mParams, mCarry);
+    }
+
+    /**
+     * Render a block of samples
+     *
+     * @tparam wave Waveform
+     * @param yn Destination buffer
+     * @param frames Number of samples to render
+     */
+    template <Waveform wave>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(float * __restrict yn, const uint32_t frames)
+    {
+      if (mSync)
+        render<wave, true>(yn, frames);
+      else
+        render<wave, false>(yn, frames);
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /** @private */
+    inline void updateSyncRatio(void)
+    {
+      mParams.ratio = mParams.dt * mParams.mdt_recip;
+    }
+
+    /** @private */
+    template <Waveform wave, bool sync>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(float * __restrict yn, const uint32_t frames)
+    {
+      Phasor phasor = mPhasor;
+      Phasor master = mMaster;
+      const Params params = mParams;
+      float carry = mCarry;
+      const float * yn_e = yn + frames;
+      for (; yn != yn_e; ) {
+        *(yn++) = step<wave, sync>(phasor, master, params, carry);
+      }
+      mPhasor = phasor;
+      mMaster = master;
+      mCarry = carry;
+    }
+
+    /** @private Naive waveform value */
+    template <Waveform wave>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float naive(const float t, const float pw)
+    {
+      switch (wave) {
+      case k_waveform_square:
+        return (t < pw) ? 1.f : -1.f;
+      case k_waveform_triangle:
+        return (t < 0.5f) ? 4.f * t - 1.f : 3.f - 4.f * t;
+      default:
+        return 2.f * t - 1.f;
+      }
+    }
+
+    /** @private Apply a step of height h occurring a samples after current one, a in (0, 1] */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void blep(const float a, const float h, float &y, float &carry)
+    {
+      const float b = 1.f - a;
+      y += 0.5f * h * b * b;
+      carry -= 0.5f * h * a * a;
+    }
+
+    /** @private Apply a slope change of m per sample occurring a samples after current one, a in (0, 1] */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void blamp(const float a, const float m, float &y, float &carry)
+    {
+      const float b = 1.f - a;
+      y += 0.16666667f * m * b * b * b;
+      carry += 0.16666667f * m * a * a * a;
+    }
+
+    /** @private */
+    template <Waveform wave, bool sync>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float step(Phasor &phasor, Phasor &master, const Params &params, float &carry)
+    {
+      const float t = phasor.phase();
+      const float dt = params.dt;
+      const float dt_recip = params.dt_recip;
+      const float pw = params.pw;
+
+      float y = naive<wave>(t, pw) + carry;
+      carry = 0.f;
+
+      // Distance to sync point in samples, events past it do not occur
+      float as = 2.f;
+      if (sync) {
+        const uq32_t mphi = master.phi;
+        master.cycle();
+        if (master.phi < mphi)
+          as = uq32_to_f32(-mphi) * params.mdt_recip;
+      }
+
+      // Distance to natural wrap around
+      const float aw = (1.f - t) * dt_recip;
+
+      switch (wave) {
+      case k_waveform_square:
+        if (t < pw) {
+          const float ap = (pw - t) * dt_recip;
+          if (ap <= 1.f && ap < as)
+            blep(ap, -2.f, y, carry);
+        }
+        if (aw <= 1.f && aw < as)
+          blep(aw, 2.f, y, carry);
+        break;
+      case k_waveform_triangle:
+        if (t < 0.5f) {
+          const float ah = (0.5f - t) * dt_recip;
+          if (ah <= 1.f && ah < as)
+            blamp(ah, -8.f * dt, y, carry);
+        }
+        if (aw <= 1.f && aw < as)
+          blamp(aw, 8.f * dt, y, carry);
+        break;
+      default:
+        if (aw <= 1.f && aw < as)
+          blep(aw, -2.f, y, carry);
+        break;
+      }
+
+      if (sync && as <= 1.f) {
+        // Phase right before the sync point, wrapped if a natural wrap occurred first
+        float ts = t + as * dt;
+        ts -= (uint32_t)ts;
+        blep(as, naive<wave>(0.f, pw) - naive<wave>(ts, pw), y, carry);
+        if (wave == k_waveform_triangle && ts >= 0.5f)
+          blamp(as, 8.f * dt, y, carry);
+        phasor.sync(master.phi, params.ratio);
+      }
+      else {
+        phasor.cycle();
+      }
+
+      return y;
+    }
+
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    Phasor mPhasor;
+    Phasor mMaster;
+    Params mParams;
+    float mCarry;
+    bool mSync;
+  };
+}
+
+/** @} */
@@ -0,0 +1,264 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    svf.hpp
+ * @brief   Topology preserving state variable filter.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ */
+
+#include "float_math.h"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Trapezoidal integrated (zero delay feedback) state variable filter.
+   *
+   * Low pass, band pass, high pass and notch responses are computed simultaneously.
+   * Unlike dsp::BiQuad, coefficients can be updated every sample at the cost of a single
+   * reciprocal, and internal state stays consistent under fast cutoff modulation.
+   */
+  struct SVF {
+
+    /*=====================================================================*/
+    /* Types and Data Structures.                                          */
+    /*=====================================================================*/
+
+    /**
+     * Filter responses
+     */
+    enum Mode {
+      k_mode_lp = 0,
+      k_mode_bp,
+      k_mode_hp,
+      k_mode_notch
+    };
+
+    /**
+     * Simultaneous filter outputs
+     */
+    typedef struct Outputs {
+      float lp;
+      float bp;
+      float hp;
+      float notch;
+    } Outputs;
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Default constructor
+     */
+    SVF(void) :
+      mZ1(0), mZ2(0),
+      mK(1.41421356f), mA1(0), mA2(0), mA3(0)
+    {
+      setCutoff(0.f);
+    }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Flush internal state
+     */
+    inline void flush(void) {
+      mZ1 = mZ2 = 0;
+    }
+
+    /**
+     * Set cutoff and resonance
+     *
+     * @param   k Tangent of PI x cutoff frequency in radians: tan(pi*wc), e.g.: osc_tanpif(wc)
+     * @param   q Quality factor, flat response at q = 1/sqrt(2)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setCoeffs(const float k, const float q) {
+      mK = 1.f / q;
+      setCutoff(k);
+    }
+
+    /**
+     * Set cutoff, keeping current resonance
+     *
+     * @param   k Tangent of PI x cutoff frequency in radians: tan(pi*wc), e.g.: osc_tanpif(wc)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setCutoff(const float k) {
+      mA1 = 1.f / (1.f + k * (k + mK));
+      mA2 = k * mA1;
+      mA3 = k * mA2;
+    }
+
+    /**
+     * Process one sample, computing all responses
+     *
+     * @param   xn Input sample
+     * @param   out Filter outputs
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float xn, Outputs &out) {
+      const float v3 = xn - mZ2;
+      const float v1 = mA1 * mZ1 + mA2 * v3;
+      const float v2 = mZ2 + mA2 * mZ1 + mA3 * v3;
+      mZ1 = 2.f * v1 - mZ1;
+      mZ2 = 2.f * v2 - mZ2;
+      out.lp = v2;
+      out.bp = v1;
+      out.notch = xn - mK * v1;
+      out.hp = out.notch - v2;
+    }
+
+    /**
+     * Process one sample
+     *
+     * @tparam  mode Filter response
+     * @param   xn Input sample
+     * @return  Output sample
+     */
+    template <Mode mode>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process(const float xn) {
+      const float v3 = xn - mZ2;
+      const float v1 = mA1 * mZ1 + mA2 * v3;
+      const float v2 = mZ2 + mA2 * mZ1 + mA3 * v3;
+      mZ1 = 2.f * v1 - mZ1;
+      mZ2 = 2.f * v2 - mZ2;
+      return output<mode>(xn, v1, v2, mK);
+    }
+
+    /**
+     * Process a block of samples at fixed cutoff
+     *
+     * @tparam  mode Filter response
+     * @param   xn Input buffer
+     * @param   yn Output buffer, may alias xn
+     * @param   frames Number of samples
+     */
+    template <Mode mode>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float *xn, float *yn, const uint32_t frames) {
+      const float a1 = mA1, a2 = mA2, a3 = mA3, k = mK;
+      float z1 = mZ1, z2 = mZ2;
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        const float x = *(xn++);
+        const float v3 = x - z2;
+        const float v1 = a1 * z1 + a2 * v3;
+        const float v2 = z2 + a2 * z1 + a3 * v3;
+        z1 = 2.f * v1 - z1;
+        z2 = 2.f * v2 - z2;
+        *(yn++) = output<mode>(x, v1, v2, k);
+      }
+      mZ1 = z1;
+      mZ2 = z2;
+    }
+
+    /**
+     * Process a block of samples with per-sample cutoff
+     *
+     * @tparam  mode Filter response
+     * @param   xn Input buffer
+     * @param   kn Cutoff buffer, tangent of PI x cutoff frequency in radians: tan(pi*wc)
+     * @param   yn Output buffer, may alias xn
+     * @param   frames Number of samples
+     * @note    Coefficients are left at the last cutoff value of the block.
+     */
+    template <Mode mode>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float *xn, const float *kn, float *yn, const uint32_t frames) {
+      const float k = mK;
+      float z1 = mZ1, z2 = mZ2;
+      float a1 = mA1, a2 = mA2, a3 = mA3;
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        const float g = *(kn++);
+        a1 = 1.f / (1.f + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+        const float x = *(xn++);
+        const float v3 = x - z2;
+        const float v1 = a1 * z1 + a2 * v3;
+        const float v2 = z2 + a2 * z1 + a3 * v3;
+        z1 = 2.f * v1 - z1;
+        z2 = 2.f * v2 - z2;
+        *(yn++) = output<mode>(x, v1, v2, k);
+      }
+      mZ1 = z1;
+      mZ2 = z2;
+      mA1 = a1;
+      mA2 = a2;
+      mA3 = a3;
+    }
+
+    /*=====================================================================*/
+    /* Private Methods.                                                    */
+    /*=====================================================================*/
+
+    /** @private */
+    template <Mode mode>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float output(const float xn, const float v1, const float v2, const float k) {
+      switch (mode) {
+      case k_mode_bp:
+        return v1;
+      case k_mode_hp:
+        return xn - k * v1 - v2;
+      case k_mode_notch:
+        return xn - k * v1;
+      default:
+        return v2;
+      }
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    float mZ1, mZ2;
+    float mK;
+    float mA1, mA2, mA3;
+  };
+}
+
+/** @} */
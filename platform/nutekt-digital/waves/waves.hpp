@@ -41,6 +41,7 @@
 
 #include "userosc.h"
 #include "biquad.hpp"
+#include "phasor.hpp"
 
 struct Waves {
 
@@ -53,6 +54,19 @@ struct Waves {
     k_flag_bitcrush = 1<<5,
     k_flag_reset    = 1<<6
   };
+
+  enum {
+    k_minblep_taps_exp  = 4,
+    k_minblep_taps      = 1<<k_minblep_taps_exp,
+    k_minblep_taps_mask = k_minblep_taps-1,
+    k_minblep_phases    = 16,
+    k_minblep_size      = k_minblep_taps * k_minblep_phases
+  };
+
+  enum {
+    k_bank_cnt = k_waves_a_cnt + k_waves_b_cnt + k_waves_c_cnt
+               + k_waves_d_cnt + k_waves_e_cnt + k_waves_f_cnt
+  };
   
   struct Params {
     float    submix;
@@ -63,7 +77,9 @@ struct Waves {
     uint8_t  wave0;
     uint8_t  wave1;
     uint8_t  subwave;
-    uint8_t  padding;
+    uint8_t  sync;
+    uint8_t  morph;
+    uint8_t  padding[3];
     
     Params(void) :
       submix(0.05f),
@@ -73,7 +89,9 @@ struct Waves {
       shiftshape(0.f),
       wave0(0),
       wave1(0),
-      subwave(0)
+      subwave(0),
+      sync(0),
+      morph(0)
     { }
   };
   
@@ -81,32 +99,37 @@ struct Waves {
     const float   *wave0;
     const float   *wave1;
     const float   *subwave;
-          float    phi0;
-          float    phi1;
-          float    phisub;
-          float    w00;
-          float    w01;
-          float    w0sub;
+    dsp::Phasor    phi0;
+    dsp::Phasor    phi1;
+    dsp::Phasor    phisub;
           float    lfo;
           float    lfoz;
           float    dither;
           float    bitres;
           float    bitresrcp;
           float    imperfection;
+          float    syncratio;
+          float    blep[k_minblep_taps];
+          uint32_t blepidx;
+          uint32_t bleppending;
+          float    morphframe[k_waves_size];
+          float    morphpos;
           uint32_t flags:8;
     
     State(void) :
       wave0(wavesA[0]),
       wave1(wavesD[0]),
       subwave(wavesA[0]),
-      w00(440.f * k_samplerate_recipf),
-      w01(440.f * k_samplerate_recipf),
-      w0sub(220.f * k_samplerate_recipf),
+      phi0(440.f * k_samplerate_recipf),
+      phi1(440.f * k_samplerate_recipf),
+      phisub(220.f * k_samplerate_recipf),
       lfo(0.f),
       lfoz(0.f),
       dither(0.f),
       bitres(1.f),
       bitresrcp(1.f),
+      syncratio(1.f),
+      morphpos(-1.f),
       flags(k_flags_none)
     {
       reset();
@@ -115,10 +138,19 @@ struct Waves {
     
     inline void reset(void)
     {
-      phi0 = 0;
-      phi1 = 0;
-      phisub = 0;
+      phi0.reset();
+      phi1.reset();
+      phisub.reset();
       lfo = lfoz;
+      flushSync();
+    }
+
+    inline void flushSync(void)
+    {
+      for (uint32_t i = 0; i < k_minblep_taps; ++i)
+        blep[i] = 0.f;
+      blepidx = 0;
+      bleppending = 0;
     }
   };
 
@@ -136,13 +168,52 @@ struct Waves {
   inline void updatePitch(float w0) {
     w0 += state.imperfection;
     const float drift = params.shiftshape;
-    state.w00 = w0;
-    // Alt osc with slight drift (0.25Hz@48KHz)
-    state.w01 = w0 + drift * 5.20833333333333e-006f;
+    state.phi0.setW0(w0);
+    if (params.sync) {
+      // Synced alt osc, shift+shape sweeps ratio from 1 to 4
+      state.syncratio = 1.f + 3.f * clip01f(drift - 1.f);
+      state.phi1.setW0(w0 * state.syncratio);
+    }
+    else {
+      // Alt osc with slight drift (0.25Hz@48KHz)
+      state.phi1.setW0(w0 + drift * 5.20833333333333e-006f);
+    }
     // Sub one octave and a phase drift (0.15Hz@48KHz)
-    state.w0sub = 0.5f * w0 + drift * 3.125e-006f;
+    state.phisub.setW0(0.5f * w0 + drift * 3.125e-006f);
   }
     
+  // Ordered A to F bank used for morphing
+  static inline const float * bankWave(uint32_t idx) {
+    if (idx < k_waves_a_cnt)
+      return wavesA[idx];
+    idx -= k_waves_a_cnt;
+    if (idx < k_waves_b_cnt)
+      return wavesB[idx];
+    idx -= k_waves_b_cnt;
+    if (idx < k_waves_c_cnt)
+      return wavesC[idx];
+    idx -= k_waves_c_cnt;
+    if (idx < k_waves_d_cnt)
+      return wavesD[idx];
+    idx -= k_waves_d_cnt;
+    if (idx < k_waves_e_cnt)
+      return wavesE[idx];
+    idx -= k_waves_e_cnt;
+    return wavesF[clipmaxu32(idx, k_waves_f_cnt-1)];
+  }
+
+  // Blend bank waves around morph position, in [0, k_bank_cnt-1], into cached frame
+  inline void updateMorphFrame(const float pos) {
+    const uint32_t idx = (uint32_t)pos;
+    const float fr = pos - idx;
+    const float *w0 = bankWave(idx);
+    const float *w1 = bankWave(clipmaxu32(idx + 1, k_bank_cnt - 1));
+    float *frame = state.morphframe;
+    for (uint32_t i = 0; i < k_waves_size; ++i)
+      frame[i] = linintf(fr, w0[i], w1[i]);
+    state.morphpos = pos;
+  }
+
   inline void updateWaves(const uint16_t flags) {
     if (flags & k_flag_wave0) {
       static const uint8_t k_a_thr = k_waves_a_cnt;
@@ -15,3 +15,5 @@ UDEFS =
 ULIB = 
 
 ULIBDIR =
+
+UMEMBUDGET =
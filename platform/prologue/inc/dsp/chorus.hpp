@@ -0,0 +1,288 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    chorus.hpp
+ * @brief   Multi voice chorus / ensemble.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include "float_math.h"
+#include "biquad.hpp"
+#include "delayline.hpp"
+#include "simplelfo.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Multi voice chorus / ensemble for main and sub timbres.
+   *
+   * Main and sub timbre inputs are summed to mono, band limited and written as one sample
+   * pair to a single delay line, so that each voice tap yields both timbres from the
+   * same address computation and memory reads. Voice delays are modulated by a control
+   * rate SimpleLFO with evenly spread phases, updated once per block and ramped across
+   * it. Voices are panned across the stereo field and the wet signal is low pass filtered
+   * to approximate bucket brigade devices.
+   *
+   * Typical modfx use:
+   * @code
+   * static __sdram dsp::DelayStorageQ15::pair_t s_chorus_ram[2048];
+   * static dsp::Chorus<3, dsp::DelayStorageQ15> s_chorus;
+   *
+   * void MODFX_INIT(uint32_t platform, uint32_t api) {
+   *   s_chorus.init(s_chorus_ram, 2048, k_samplerate);
+   * }
+   *
+   * void MODFX_PROCESS(const float *main_xn, float *main_yn,
+   *                    const float *sub_xn,  float *sub_yn,
+   *                    uint32_t frames) {
+   *   s_chorus.process(main_xn, main_yn, sub_xn, sub_yn, frames);
+   * }
+   * @endcode
+   *
+   * @tparam V Number of voices, 2 to 6 are typical
+   * @tparam Storage Delay line storage format, see DelayStorageF32 and DelayStorageQ15
+   */
+  template <uint32_t V, typename Storage = DelayStorageF32>
+  struct Chorus {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    typedef BasicDualDelayLine<Storage> line_t;
+    typedef typename line_t::pair_t pair_t;
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Chorus(void) :
+      mFsRecip(1.f / 48000.f),
+      mRate(0.5f),
+      mCenter(0.f),
+      mDepth(0.f),
+      mDry(1.f),
+      mWet(0.5f)
+    {
+      for (uint32_t v = 0; v < V; ++v)
+        mDelay[v] = 0.f;
+      setSpread(1.f);
+    }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Initialize with backing memory and sampling rate
+     *
+     * @param ram Delay memory
+     * @param line_size Size in sample pairs of delay memory, power of two
+     * @param fs Sampling frequency in Hz
+     */
+    inline void init(pair_t *ram, size_t line_size, const float fs) {
+      mLine.setMemory(ram, line_size);
+      mLine.clear();
+      mFsRecip = 1.f / fs;
+      mLfo.reset();
+      setDelay(0.012f, 0.004f);
+      for (uint32_t v = 0; v < V; ++v)
+        mDelay[v] = mCenter;
+      // Default to a BBD like 8kHz band limit at 48kHz
+      setFilters(0.57735027f, 0.57735027f);
+      flush();
+    }
+
+    /**
+     * Clear delay memory and filter states
+     */
+    inline void flush(void) {
+      mLine.clear();
+      for (uint32_t i = 0; i < 2; ++i)
+        mPreFilter[i].flush();
+      for (uint32_t i = 0; i < 4; ++i)
+        mPostFilter[i].flush();
+    }
+
+    /**
+     * Set modulation rate
+     *
+     * @param hz LFO frequency in Hz
+     */
+    inline void setRate(const float hz) {
+      mRate = hz;
+    }
+
+    /**
+     * Set center delay time and modulation depth
+     *
+     * @param center Center delay in seconds
+     * @param depth Modulation depth in seconds, each side of center
+     */
+    inline void setDelay(const float center, const float depth) {
+      const float fs = 1.f / mFsRecip;
+      // Keep taps within line, leaving room for interpolation
+      const float max = (float)(mLine.mSize - 2);
+      mCenter = clipminmaxf(1.f, center * fs, max);
+      mDepth = clipminmaxf(0.f, depth * fs, clipmaxf(mCenter - 1.f, max - mCenter));
+    }
+
+    /**
+     * Set stereo spread of voices
+     *
+     * @param spread 0 for all voices centered, 1 for voices spread from left to right
+     */
+    inline void setSpread(const float spread) {
+      const float s = clip01f(spread);
+      const float norm = 1.f / V;
+      for (uint32_t v = 0; v < V; ++v) {
+        const float pan = (V > 1) ? s * (2.f * v / (V - 1) - 1.f) : 0.f;
+        mGain[v] = f32pair(norm * (1.f - pan), norm * (1.f + pan));
+      }
+    }
+
+    /**
+     * Set dry and wet levels
+     */
+    inline void setMix(const float dry, const float wet) {
+      mDry = dry;
+      mWet = wet;
+    }
+
+    /**
+     * Set band limiting filters
+     *
+     * @param pre_k Input low pass cutoff as tan(pi*wc), e.g.: fx_tanpif(wc)
+     * @param post_k Wet signal low pass cutoff as tan(pi*wc), e.g.: fx_tanpif(wc)
+     */
+    inline void setFilters(const float pre_k, const float post_k) {
+      mPreFilter[0].mCoeffs.setSOLP(pre_k, 0.70710678f);
+      mPreFilter[1].mCoeffs = mPreFilter[0].mCoeffs;
+      mPostFilter[0].mCoeffs.setFOLP(post_k);
+      for (uint32_t i = 1; i < 4; ++i)
+        mPostFilter[i].mCoeffs = mPostFilter[0].mCoeffs;
+    }
+
+    /**
+     * Process main and sub timbre interleaved stereo buffers
+     *
+     * @param main_xn Main timbre input
+     * @param main_yn Main timbre output, can be the same as input
+     * @param sub_xn Sub timbre input
+     * @param sub_yn Sub timbre output, can be the same as input
+     * @param frames Number of stereo frames
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float * main_xn, float * main_yn,
+                 const float * sub_xn, float * sub_yn,
+                 const uint32_t frames) {
+      // Control rate modulation, one LFO step per block
+      mLfo.setF0(mRate * frames, mFsRecip);
+      mLfo.cycle();
+
+      const float frames_recip = 1.f / frames;
+      float delay[V];
+      float delay_inc[V];
+      for (uint32_t v = 0; v < V; ++v) {
+        const float target = mCenter + mDepth * mLfo.sine_bi_off((float)v / V);
+        delay[v] = mDelay[v];
+        delay_inc[v] = (target - delay[v]) * frames_recip;
+        mDelay[v] = target;
+      }
+
+      const pair_t * line = mLine.mLine;
+      const uint32_t mask = mLine.mMask;
+      const float dry = mDry;
+      const float wet = mWet;
+
+      const float * xn_e = main_xn + 2 * frames;
+      for (; main_xn != xn_e; main_xn += 2, sub_xn += 2, main_yn += 2, sub_yn += 2) {
+        const float main_l = main_xn[0], main_r = main_xn[1];
+        const float sub_l = sub_xn[0], sub_r = sub_xn[1];
+
+        mLine.write(f32pair(mPreFilter[0].process_so(0.5f * (main_l + main_r)),
+                            mPreFilter[1].process_so(0.5f * (sub_l + sub_r))));
+
+        // All taps share write index, each returns main and sub timbre samples
+        const uint32_t widx = mLine.mWriteIdx;
+        f32pair_t wet_main = f32pair(0.f, 0.f);
+        f32pair_t wet_sub = f32pair(0.f, 0.f);
+        for (uint32_t v = 0; v < V; ++v) {
+          const float d = (delay[v] += delay_inc[v]);
+          const uint32_t base = (uint32_t)d;
+          const uint32_t idx = widx + base;
+          const f32pair_t tap = f32pair_linint(d - base,
+                                               Storage::load(line[idx & mask]),
+                                               Storage::load(line[(idx + 1) & mask]));
+          const f32pair_t g = mGain[v];
+          wet_main = f32pair_add(wet_main, f32pair_mulscal(g, tap.a));
+          wet_sub = f32pair_add(wet_sub, f32pair_mulscal(g, tap.b));
+        }
+
+        main_yn[0] = dry * main_l + wet * mPostFilter[0].process_fo(wet_main.a);
+        main_yn[1] = dry * main_r + wet * mPostFilter[1].process_fo(wet_main.b);
+        sub_yn[0] = dry * sub_l + wet * mPostFilter[2].process_fo(wet_sub.a);
+        sub_yn[1] = dry * sub_r + wet * mPostFilter[3].process_fo(wet_sub.b);
+      }
+    }
+
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    line_t     mLine;
+    SimpleLFO  mLfo;
+    BiQuad     mPreFilter[2];
+    BiQuad     mPostFilter[4];
+    f32pair_t  mGain[V];
+    float      mDelay[V];
+    float      mFsRecip;
+    float      mRate;
+    float      mCenter;
+    float      mDepth;
+    float      mDry;
+    float      mWet;
+  };
+}
+
+/** @} */
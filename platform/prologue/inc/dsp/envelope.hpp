@@ -0,0 +1,493 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    envelope.hpp
+ * @brief   Exponential segment ADSR and AR envelope generators.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Exponential envelope segment.
+   *
+   * Approaches an overshot target with a one pole recursion, y = base + coeff * y, so
+   * that each sample costs a single multiply-add and the segment ends in finite time
+   * when the actual target is crossed. Smaller ratios give more exponential curves.
+   */
+  struct EnvelopeSegment {
+
+    EnvelopeSegment(void) :
+      coeff(0.f), base(0.f), ratio(1e-3f)
+    { }
+
+    /**
+     * Compute coefficients
+     *
+     * @param samples Duration in samples
+     * @param start Start level of the segment
+     * @param target End level of the segment
+     * @param shape_ratio Overshoot relative to the segment range
+     */
+    inline void set(const float samples, const float start, const float target, const float shape_ratio) {
+      ratio = shape_ratio;
+      coeff = (samples <= 1.f) ? 0.f : expf(-logf((1.f + ratio) / ratio) / samples);
+      retarget(start, target);
+    }
+
+    /**
+     * Update target keeping the current duration
+     */
+    inline void retarget(const float start, const float target) {
+      const float aim = target + (target - start) * ratio;
+      base = aim * (1.f - coeff);
+    }
+
+    float coeff;
+    float base;
+    float ratio;
+  };
+
+  /**
+   * ADSR envelope coefficients and stepping logic, shared between voices.
+   */
+  struct ADSRCoeffs {
+
+    enum Stage {
+      k_stage_idle = 0,
+      k_stage_attack,
+      k_stage_decay,
+      k_stage_sustain,
+      k_stage_release
+    };
+
+    ADSRCoeffs(void) :
+      sustain(1.f),
+      fs(48000.f),
+      attack_time(0.005f),
+      decay_time(0.1f),
+      release_time(0.1f)
+    {
+      update();
+    }
+
+    /**
+     * Set sampling rate envelopes are rendered at
+     */
+    inline void setSampleRate(const float f) {
+      fs = f;
+      update();
+    }
+
+    /**
+     * Set attack time in seconds
+     */
+    inline void setAttack(const float seconds) {
+      attack_time = seconds;
+      attack.set(seconds * fs, 0.f, 1.f, 0.3f);
+    }
+
+    /**
+     * Set decay time in seconds
+     */
+    inline void setDecay(const float seconds) {
+      decay_time = seconds;
+      decay.set(seconds * fs, 1.f, sustain, 1e-4f);
+    }
+
+    /**
+     * Set sustain level in [0, 1]
+     */
+    inline void setSustain(const float level) {
+      sustain = (level < 0.f) ? 0.f : (level > 1.f) ? 1.f : level;
+      decay.retarget(1.f, sustain);
+    }
+
+    /**
+     * Set release time in seconds
+     */
+    inline void setRelease(const float seconds) {
+      release_time = seconds;
+      release.set(seconds * fs, 1.f, 0.f, 1e-4f);
+    }
+
+    /** @private */
+    inline void update(void) {
+      setAttack(attack_time);
+      setDecay(decay_time);
+      setRelease(release_time);
+    }
+
+    /**
+     * Compute one sample
+     *
+     * @param y Envelope level, updated
+     * @param stage Envelope stage, updated
+     * @return New level
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float step(float &y, uint8_t &stage) const {
+      switch (stage) {
+      case k_stage_attack:
+        y = attack.base + attack.coeff * y;
+        if (y >= 1.f) {
+          y = 1.f;
+          stage = k_stage_decay;
+        }
+        break;
+      case k_stage_decay:
+        y = decay.base + decay.coeff * y;
+        if (y <= sustain) {
+          y = sustain;
+          stage = (sustain > 0.f) ? k_stage_sustain : k_stage_idle;
+        }
+        break;
+      case k_stage_release:
+        y = release.base + release.coeff * y;
+        if (y <= 0.f) {
+          y = 0.f;
+          stage = k_stage_idle;
+        }
+        break;
+      default:
+        break;
+      }
+      return y;
+    }
+
+    /**
+     * Render a block of samples
+     *
+     * Each stage runs in its own tight loop, only checking for the end of the segment.
+     *
+     * @param y Envelope level, updated
+     * @param stage Envelope stage, updated
+     * @param yn Output buffer
+     * @param frames Number of samples to render
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(float &y, uint8_t &stage, float * __restrict yn, uint32_t frames) const {
+      float * const yn_e = yn + frames;
+      float level = y;
+      while (yn != yn_e) {
+        switch (stage) {
+        case k_stage_attack:
+          {
+            const float c = attack.coeff, b = attack.base;
+            for (; yn != yn_e; ) {
+              level = b + c * level;
+              if (level >= 1.f) {
+                level = 1.f;
+                stage = k_stage_decay;
+                *(yn++) = level;
+                break;
+              }
+              *(yn++) = level;
+            }
+          }
+          break;
+        case k_stage_decay:
+          {
+            const float c = decay.coeff, b = decay.base, s = sustain;
+            for (; yn != yn_e; ) {
+              level = b + c * level;
+              if (level <= s) {
+                level = s;
+                stage = (s > 0.f) ? k_stage_sustain : k_stage_idle;
+                *(yn++) = level;
+                break;
+              }
+              *(yn++) = level;
+            }
+          }
+          break;
+        case k_stage_release:
+          {
+            const float c = release.coeff, b = release.base;
+            for (; yn != yn_e; ) {
+              level = b + c * level;
+              if (level <= 0.f) {
+                level = 0.f;
+                stage = k_stage_idle;
+                *(yn++) = level;
+                break;
+              }
+              *(yn++) = level;
+            }
+          }
+          break;
+        default:
+          // Idle and sustain hold current level
+          for (; yn != yn_e; )
+            *(yn++) = level;
+          break;
+        }
+      }
+      y = level;
+    }
+
+    EnvelopeSegment attack;
+    EnvelopeSegment decay;
+    EnvelopeSegment release;
+    float sustain;
+    float fs;
+    float attack_time;
+    float decay_time;
+    float release_time;
+  };
+
+  /**
+   * Behavior of gate on events while the envelope is still active
+   */
+  enum EnvelopeTrigger {
+    k_envelope_retrigger = 0, ///< Restart attack from current level
+    k_envelope_reset,         ///< Restart attack from zero
+    k_envelope_legato         ///< Ignore gate on while gated
+  };
+
+  /**
+   * Single voice ADSR envelope
+   */
+  struct ADSR : public ADSRCoeffs {
+
+    ADSR(void) :
+      mLevel(0.f),
+      mStage(k_stage_idle),
+      mTrigger(k_envelope_retrigger)
+    { }
+
+    /**
+     * Set gate on behavior
+     */
+    inline void setTrigger(const EnvelopeTrigger trigger) {
+      mTrigger = trigger;
+    }
+
+    /**
+     * Start attack stage
+     */
+    inline void gateOn(void) {
+      if (mTrigger == k_envelope_legato && isGated())
+        return;
+      if (mTrigger == k_envelope_reset)
+        mLevel = 0.f;
+      mStage = k_stage_attack;
+    }
+
+    /**
+     * Start release stage
+     */
+    inline void gateOff(void) {
+      if (mStage != k_stage_idle)
+        mStage = k_stage_release;
+    }
+
+    /**
+     * Silence immediately
+     */
+    inline void reset(void) {
+      mLevel = 0.f;
+      mStage = k_stage_idle;
+    }
+
+    inline bool isGated(void) const {
+      return (mStage != k_stage_idle && mStage != k_stage_release);
+    }
+
+    inline bool isActive(void) const {
+      return (mStage != k_stage_idle);
+    }
+
+    inline float level(void) const {
+      return mLevel;
+    }
+
+    /**
+     * Compute next sample
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float process(void) {
+      return step(mLevel, mStage);
+    }
+
+    /**
+     * Render a block of samples
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(float * __restrict yn, const uint32_t frames) {
+      render(mLevel, mStage, yn, frames);
+    }
+
+    float    mLevel;
+    uint8_t  mStage;
+    uint8_t  mTrigger;
+  };
+
+  /**
+   * Single voice AR envelope
+   *
+   * In one shot mode a trigger runs attack then release regardless of gate length,
+   * otherwise the envelope holds full level while gated.
+   */
+  struct AR : public ADSR {
+
+    AR(void) :
+      mOneShot(true)
+    {
+      setSustain(0.f);
+    }
+
+    /**
+     * Select one shot or gated operation
+     */
+    inline void setOneShot(const bool oneshot) {
+      mOneShot = oneshot;
+      setSustain(oneshot ? 0.f : 1.f);
+      setDecay(oneshot ? release_time : 0.f);
+    }
+
+    /**
+     * Set release time in seconds
+     */
+    inline void setRelease(const float seconds) {
+      ADSR::setRelease(seconds);
+      if (mOneShot)
+        setDecay(seconds);
+    }
+
+    /**
+     * Start envelope
+     */
+    inline void trigger(void) {
+      gateOn();
+    }
+
+    /**
+     * Start release stage, ignored in one shot mode so that attack always completes
+     */
+    inline void gateOff(void) {
+      if (!mOneShot)
+        ADSR::gateOff();
+    }
+
+    bool mOneShot;
+  };
+
+  /**
+   * Bank of N ADSR envelopes sharing timing parameters, e.g.: one per voice.
+   *
+   * Levels and stages are kept in parallel arrays so that all voices can be stepped
+   * together, or rendered as per voice blocks.
+   *
+   * @tparam N Number of envelopes
+   */
+  template <uint32_t N>
+  struct ADSRBank : public ADSRCoeffs {
+
+    ADSRBank(void) :
+      mTrigger(k_envelope_retrigger)
+    {
+      reset();
+    }
+
+    inline void setTrigger(const EnvelopeTrigger trigger) {
+      mTrigger = trigger;
+    }
+
+    inline void reset(void) {
+      for (uint32_t i = 0; i < N; ++i) {
+        mLevel[i] = 0.f;
+        mStage[i] = k_stage_idle;
+      }
+    }
+
+    inline void gateOn(const uint32_t idx) {
+      const uint8_t stage = mStage[idx];
+      if (mTrigger == k_envelope_legato && stage != k_stage_idle && stage != k_stage_release)
+        return;
+      if (mTrigger == k_envelope_reset)
+        mLevel[idx] = 0.f;
+      mStage[idx] = k_stage_attack;
+    }
+
+    inline void gateOff(const uint32_t idx) {
+      if (mStage[idx] != k_stage_idle)
+        mStage[idx] = k_stage_release;
+    }
+
+    inline bool isActive(const uint32_t idx) const {
+      return (mStage[idx] != k_stage_idle);
+    }
+
+    inline float level(const uint32_t idx) const {
+      return mLevel[idx];
+    }
+
+    /**
+     * Step all envelopes by one sample
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(void) {
+      for (uint32_t i = 0; i < N; ++i)
+        step(mLevel[i], mStage[i]);
+    }
+
+    /**
+     * Render a block of samples for all envelopes
+     *
+     * @param yn Output buffer of N * frames values, envelope idx written to yn[idx * frames + n]
+     * @param frames Number of samples to render
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(float * __restrict yn, const uint32_t frames) {
+      for (uint32_t i = 0; i < N; ++i, yn += frames)
+        render(mLevel[i], mStage[i], yn, frames);
+    }
+
+    float    mLevel[N];
+    uint8_t  mStage[N];
+    uint8_t  mTrigger;
+  };
+}
+
+/** @} */
@@ -0,0 +1,424 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    oversampler.hpp
+ * @brief   Block oversampling with polyphase IIR half-band filters.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ */
+
+#include "float_math.h"
+#include "buffer_ops.h"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Steepness presets for oversampling anti-imaging/anti-aliasing filters.
+   *
+   * Attenuation and passband edge given for the first 2x stage of a 48kHz stream.
+   */
+  enum {
+    /** 4 coefficients, ~70dB rejection, flat up to ~14.4kHz */
+    k_oversampling_soft = 0,
+    /** 6 coefficients, ~85dB rejection, flat up to ~18.2kHz */
+    k_oversampling_medium,
+    /** 8 coefficients, ~99dB rejection, flat up to ~20.2kHz */
+    k_oversampling_steep
+  };
+
+  /**
+   * Polyphase IIR half-band filter coefficients per steepness and oversampling stage.
+   *
+   * Stages following the first one operate at higher rates relative to the audio band
+   * and thus get away with shallower designs.
+   */
+  template <uint32_t steepness, uint32_t stage>
+  struct HalfBandDesign;
+
+  /** @private */
+  template <> struct HalfBandDesign<k_oversampling_soft, 0> {
+    enum { k_coeffs = 4 };
+    static inline const float * coeffs(void) {
+      static const float c[k_coeffs] = { 0.079866426f, 0.283829345f, 0.545323651f, 0.834411891f };
+      return c;
+    }
+  };
+
+  /** @private */
+  template <> struct HalfBandDesign<k_oversampling_medium, 0> {
+    enum { k_coeffs = 6 };
+    static inline const float * coeffs(void) {
+      static const float c[k_coeffs] = { 0.054217526f, 0.196797970f, 0.383087327f, 0.573136411f, 0.748720944f, 0.914293710f };
+      return c;
+    }
+  };
+
+  /** @private */
+  template <> struct HalfBandDesign<k_oversampling_steep, 0> {
+    enum { k_coeffs = 8 };
+    static inline const float * coeffs(void) {
+      static const float c[k_coeffs] = { 0.040633461f, 0.150505129f, 0.300757056f, 0.460774505f,
+                                         0.609524315f, 0.738503841f, 0.849223810f, 0.949742784f };
+      return c;
+    }
+  };
+
+  /** @private */
+  template <> struct HalfBandDesign<k_oversampling_soft, 1> {
+    enum { k_coeffs = 3 };
+    static inline const float * coeffs(void) {
+      static const float c[k_coeffs] = { 0.100660052f, 0.364796481f, 0.746955542f };
+      return c;
+    }
+  };
+
+  /** @private */
+  template <uint32_t steepness> struct HalfBandDesign<steepness, 1> {
+    enum { k_coeffs = 4 };
+    static inline const float * coeffs(void) {
+      static const float c[k_coeffs] = { 0.061845868f, 0.231494964f, 0.478980557f, 0.798233686f };
+      return c;
+    }
+  };
+
+  /** @private */
+  template <> struct HalfBandDesign<k_oversampling_soft, 2> {
+    enum { k_coeffs = 2 };
+    static inline const float * coeffs(void) {
+      static const float c[k_coeffs] = { 0.158565298f, 0.616251839f };
+      return c;
+    }
+  };
+
+  /** @private */
+  template <uint32_t steepness> struct HalfBandDesign<steepness, 2> {
+    enum { k_coeffs = 3 };
+    static inline const float * coeffs(void) {
+      static const float c[k_coeffs] = { 0.081984180f, 0.317132199f, 0.710942572f };
+      return c;
+    }
+  };
+
+  /**
+   * Polyphase IIR half-band filter made of two parallel all-pass chains.
+   *
+   * Coefficients alternate between the two chains, both chains are stepped together
+   * so that their independent operations can be interleaved in the FPU pipeline.
+   *
+   * @tparam num_coeffs Number of first order all-pass sections.
+   */
+  template <uint32_t num_coeffs>
+  struct HalfBandIIR {
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Default constructor
+     */
+    HalfBandIIR(void)
+    {
+      for (uint32_t i = 0; i < num_coeffs; ++i)
+        mCoeffs[i] = 0.f;
+      flush();
+    }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Set all-pass coefficients
+     *
+     * @param coeffs Array of num_coeffs coefficients, see dsp::HalfBandDesign
+     */
+    inline void setCoeffs(const float *coeffs) {
+      for (uint32_t i = 0; i < num_coeffs; ++i)
+        mCoeffs[i] = coeffs[i];
+    }
+
+    /**
+     * Flush internal delays
+     */
+    inline void flush(void) {
+      for (uint32_t i = 0; i < num_coeffs; ++i)
+        mX[i] = mY[i] = 0.f;
+    }
+
+    /**
+     * Upsample by a factor of 2
+     *
+     * @param xn Input buffer
+     * @param yn Output buffer, 2 samples per input sample
+     * @param frames Number of input samples
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void upsample(const float * __restrict xn, float * __restrict yn, const uint32_t frames) {
+      float c[num_coeffs], x[num_coeffs], y[num_coeffs];
+      load(c, x, y);
+      const float * xn_e = xn + frames;
+      for (; xn != xn_e; ) {
+        float s0 = *(xn++);
+        float s1 = s0;
+        step(c, x, y, s0, s1);
+        *(yn++) = s0;
+        *(yn++) = s1;
+      }
+      store(x, y);
+    }
+
+    /**
+     * Downsample by a factor of 2
+     *
+     * @param xn Input buffer, 2 samples per output sample
+     * @param yn Output buffer, may alias xn
+     * @param frames Number of output samples
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void downsample(const float *xn, float *yn, const uint32_t frames) {
+      float c[num_coeffs], x[num_coeffs], y[num_coeffs];
+      load(c, x, y);
+      const float * yn_e = yn + frames;
+      for (; yn != yn_e; xn += 2) {
+        float s0 = xn[1];
+        float s1 = xn[0];
+        step(c, x, y, s0, s1);
+        *(yn++) = 0.5f * (s0 + s1);
+      }
+      store(x, y);
+    }
+
+    /*=====================================================================*/
+    /* Private Methods.                                                    */
+    /*=====================================================================*/
+
+    /** @private */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void load(float *c, float *x, float *y) const {
+      for (uint32_t i = 0; i < num_coeffs; ++i) {
+        c[i] = mCoeffs[i];
+        x[i] = mX[i];
+        y[i] = mY[i];
+      }
+    }
+
+    /** @private */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void store(const float *x, const float *y) {
+      for (uint32_t i = 0; i < num_coeffs; ++i) {
+        mX[i] = x[i];
+        mY[i] = y[i];
+      }
+    }
+
+    /** @private */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void step(const float *c, float *x, float *y, float &s0, float &s1) {
+      uint32_t i = 0;
+      for (; i + 1 < num_coeffs; i += 2) {
+        const float t0 = (s0 - y[i]) * c[i] + x[i];
+        const float t1 = (s1 - y[i+1]) * c[i+1] + x[i+1];
+        x[i] = s0;
+        x[i+1] = s1;
+        y[i] = s0 = t0;
+        y[i+1] = s1 = t1;
+      }
+      if (num_coeffs & 1) {
+        const float t0 = (s0 - y[i]) * c[i] + x[i];
+        x[i] = s0;
+        y[i] = s0 = t0;
+      }
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    float mCoeffs[num_coeffs];
+    float mX[num_coeffs];
+    float mY[num_coeffs];
+  };
+
+  /**
+   * Block oversampler for nonlinear processing stages.
+   *
+   * Upsamples a block, lets a user function process it at the higher rate, then
+   * filters and decimates back to the original rate.
+   *
+   * E.g.:
+   *   dsp::Oversampler<4> os;
+   *   os.process(xn, yn, frames, [](float *buf, uint32_t n) { ... });
+   *
+   * @tparam factor Oversampling factor: 2, 4 or 8
+   * @tparam steepness Filter steepness preset, see k_oversampling_soft/medium/steep
+   * @tparam max_frames Maximum number of frames per call at original rate
+   *
+   * @note Mono, use one instance per channel.
+   * @note Uses max_frames * factor * 1.5 floats of work memory.
+   */
+  template <uint32_t factor, uint32_t steepness = k_oversampling_medium, uint32_t max_frames = 64>
+  struct Oversampler {
+
+    /*=====================================================================*/
+    /* Types and Data Structures.                                          */
+    /*=====================================================================*/
+
+    enum {
+      k_stages = (factor == 8) ? 3 : (factor == 4) ? 2 : 1
+    };
+
+    static_assert(factor == 2 || factor == 4 || factor == 8, "Oversampling factor must be 2, 4 or 8");
+
+    typedef HalfBandDesign<steepness, 0> Design0;
+    typedef HalfBandDesign<steepness, 1> Design1;
+    typedef HalfBandDesign<steepness, 2> Design2;
+
+    /*=====================================================================*/
+    /* Constructor / Destructor.                                           */
+    /*=====================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Oversampler(void)
+    {
+      mUp0.setCoeffs(Design0::coeffs());
+      mDown0.setCoeffs(Design0::coeffs());
+      if (k_stages > 1) {
+        mUp1.setCoeffs(Design1::coeffs());
+        mDown1.setCoeffs(Design1::coeffs());
+      }
+      if (k_stages > 2) {
+        mUp2.setCoeffs(Design2::coeffs());
+        mDown2.setCoeffs(Design2::coeffs());
+      }
+    }
+
+    /*=====================================================================*/
+    /* Public Methods.                                                     */
+    /*=====================================================================*/
+
+    /**
+     * Flush internal filter states
+     */
+    inline void flush(void) {
+      mUp0.flush(); mDown0.flush();
+      mUp1.flush(); mDown1.flush();
+      mUp2.flush(); mDown2.flush();
+    }
+
+    /**
+     * Upsample a block into the internal oversampled buffer
+     *
+     * @param xn Input buffer
+     * @param frames Number of input samples, at most max_frames
+     * @return Pointer to frames * factor oversampled samples
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float * upsample(const float *xn, const uint32_t frames) {
+      // Ping-pong between buffers so that the last stage lands in mBuf
+      if (k_stages == 1) {
+        mUp0.upsample(xn, mBuf, frames);
+      }
+      else if (k_stages == 2) {
+        mUp0.upsample(xn, mTmp, frames);
+        mUp1.upsample(mTmp, mBuf, frames << 1);
+      }
+      else {
+        mUp0.upsample(xn, mBuf, frames);
+        mUp1.upsample(mBuf, mTmp, frames << 1);
+        mUp2.upsample(mTmp, mBuf, frames << 2);
+      }
+      return mBuf;
+    }
+
+    /**
+     * Decimate the internal oversampled buffer back to original rate
+     *
+     * @param yn Output buffer
+     * @param frames Number of output samples, at most max_frames
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void downsample(float *yn, const uint32_t frames) {
+      // Decimation can be performed in place
+      if (k_stages > 2)
+        mDown2.downsample(mBuf, mBuf, frames << 2);
+      if (k_stages > 1)
+        mDown1.downsample(mBuf, mBuf, frames << 1);
+      mDown0.downsample(mBuf, yn, frames);
+    }
+
+    /**
+     * Run a processing function at oversampled rate
+     *
+     * @param xn Input buffer
+     * @param yn Output buffer, may alias xn
+     * @param frames Number of samples
+     * @param fn Callable with signature void(float *buf, uint32_t len) processing buf in place
+     */
+    template <typename Fn>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float *xn, float *yn, uint32_t frames, Fn fn) {
+      while (frames) {
+        const uint32_t len = (frames > max_frames) ? max_frames : frames;
+        float *buf = upsample(xn, len);
+        fn(buf, len * factor);
+        downsample(yn, len);
+        xn += len;
+        yn += len;
+        frames -= len;
+      }
+    }
+
+    /*=====================================================================*/
+    /* Member Variables.                                                   */
+    /*=====================================================================*/
+
+    HalfBandIIR<Design0::k_coeffs> mUp0, mDown0;
+    HalfBandIIR<Design1::k_coeffs> mUp1, mDown1;
+    HalfBandIIR<Design2::k_coeffs> mUp2, mDown2;
+
+    float mBuf[max_frames * factor];
+    float mTmp[(max_frames * factor) >> 1];
+  };
+}
+
+/** @} */
@@ -0,0 +1,273 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    silence.hpp
+ * @brief   Silence detection and effect tail tracking.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Check whether a buffer is silent
+   *
+   * @param xn Buffer
+   * @param len Number of samples, e.g.: 2 * frames for interleaved stereo
+   * @param threshold Absolute level under which samples are considered silent
+   * @return True if no sample exceeds the threshold
+   */
+  static inline __attribute__((optimize("Ofast"),always_inline))
+  bool buf_is_silent(const float * xn, const uint32_t len, const float threshold = 1e-6f) {
+    const float * xn_e = xn + len;
+    for (; xn != xn_e; ++xn) {
+      if (fabsf(*xn) > threshold)
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * Tracks input silence and effect tail to skip processing once an effect has decayed.
+   *
+   * The effect is considered active while the input is not silent, and for the duration
+   * of its tail after the input went silent. The tail can be ended early when the effect
+   * output has been silent for the hold time set with setOutputHold(), so conservative
+   * tail estimates cost little. Non silent input makes the effect active again within the
+   * same block.
+   *
+   * Typical delfx use, where the output is silent between echoes so the hold time must
+   * cover the delay time:
+   * @code
+   * void DELFX_PARAM(uint8_t index, int32_t value) {
+   *   ...
+   *   s_tail.setTail(dsp::TailTracker::delayTail(delay_frames, feedback));
+   *   s_tail.setOutputHold(delay_frames);
+   * }
+   *
+   * void DELFX_PROCESS(float *xn, uint32_t frames) {
+   *   switch (s_tail.update(xn, 2 * frames, frames)) {
+   *   case dsp::TailTracker::k_idle:
+   *     return;  // Silent input passes through unchanged
+   *   case dsp::TailTracker::k_enter_idle:
+   *     s_delay.clear(); // Drop decayed state, avoids denormals
+   *     return;
+   *   default:
+   *     break;
+   *   }
+   *   s_delay.process(xn, frames);
+   *   s_tail.checkOutput(xn, 2 * frames, frames);
+   * }
+   * @endcode
+   */
+  struct TailTracker {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum Status {
+      k_active = 0, ///< Effect must be processed
+      k_enter_idle, ///< Tail just ended, effect state may be flushed
+      k_idle        ///< Effect can be skipped
+    };
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    TailTracker(void) :
+      mTail(0),
+      mQuiet(0),
+      mHold(0xFFFFFFFFU),
+      mOutputQuiet(0),
+      mThreshold(1e-6f),
+      mActive(true)
+    { }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Set tail length
+     *
+     * @param frames Duration in frames the effect keeps producing output after silent input
+     */
+    inline void setTail(const uint32_t frames) {
+      mTail = frames;
+    }
+
+    /**
+     * Set how long the output must stay silent before ending the tail early
+     *
+     * Disabled until set. Effects with gaps in their output, e.g.: delays, need at least
+     * their longest internal delay, while effects with a continuous decay, e.g.: reverbs,
+     * can use a single block.
+     *
+     * @param frames Duration in frames, counted with checkOutput()
+     */
+    inline void setOutputHold(const uint32_t frames) {
+      mHold = frames;
+    }
+
+    /**
+     * Set level under which samples are considered silent
+     *
+     * @param threshold Absolute sample level, e.g.: 1e-6f for about -120dB
+     */
+    inline void setThreshold(const float threshold) {
+      mThreshold = threshold;
+    }
+
+    /**
+     * Force processing to resume, e.g.: after a parameter or state change
+     */
+    inline void reset(void) {
+      mActive = true;
+      mQuiet = 0;
+      mOutputQuiet = 0;
+    }
+
+    /**
+     * Whether the effect is currently processed
+     */
+    inline bool isActive(void) const {
+      return mActive;
+    }
+
+    /**
+     * Update tracker with a new input block
+     *
+     * @param xn Input buffer
+     * @param len Number of samples in input buffer
+     * @param frames Number of frames in block
+     * @return Processing status for this block
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    Status update(const float * xn, const uint32_t len, const uint32_t frames) {
+      if (!buf_is_silent(xn, len, mThreshold)) {
+        mActive = true;
+        mQuiet = 0;
+        mOutputQuiet = 0;
+        return k_active;
+      }
+
+      if (!mActive)
+        return k_idle;
+
+      mQuiet += frames;
+      if (mQuiet > mTail || mOutputQuiet >= mHold) {
+        mActive = false;
+        return k_enter_idle;
+      }
+      return k_active;
+    }
+
+    /**
+     * Optionally report output of the last processed block to end the tail early
+     *
+     * The tail ends once output stayed silent for the hold time, see setOutputHold().
+     *
+     * @param yn Output buffer
+     * @param len Number of samples in output buffer
+     * @param frames Number of frames in block
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void checkOutput(const float * yn, const uint32_t len, const uint32_t frames) {
+      // Only worth scanning once input went silent
+      if (!mQuiet)
+        return;
+      if (buf_is_silent(yn, len, mThreshold))
+        mOutputQuiet += frames;
+      else
+        mOutputQuiet = 0;
+    }
+
+    /*===========================================================================*/
+    /* Tail Estimation.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * Estimate tail of a feedback delay
+     *
+     * @param delay Delay time in frames
+     * @param feedback Feedback gain in [0, 1)
+     * @param threshold Level relative to input at which the tail is considered over
+     * @return Tail length in frames
+     */
+    static inline uint32_t delayTail(const float delay, const float feedback, const float threshold = 1e-6f) {
+      const float fb = fabsf(feedback);
+      // Echo n has level fb^(n-1)
+      const float repeats = (fb > 1e-6f) ? 1.f + logf(threshold) / logf(fb < 0.9999f ? fb : 0.9999f) : 1.f;
+      return (uint32_t)(delay * repeats) + 1;
+    }
+
+    /**
+     * Estimate tail of an exponentially decaying effect, e.g.: a reverb
+     *
+     * @param rt60 Time in frames to decay by 60dB
+     * @param threshold Level relative to input at which the tail is considered over
+     * @return Tail length in frames
+     */
+    static inline uint32_t decayTail(const float rt60, const float threshold = 1e-6f) {
+      // log10(threshold) / log10(1e-3) decades of 60dB
+      return (uint32_t)(rt60 * logf(threshold) * (1.f / -6.9077553f)) + 1;
+    }
+
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    uint32_t mTail;
+    uint32_t mQuiet;
+    uint32_t mHold;
+    uint32_t mOutputQuiet;
+    float    mThreshold;
+    bool     mActive;
+  };
+}
+
+/** @} */
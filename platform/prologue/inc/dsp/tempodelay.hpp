@@ -0,0 +1,380 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    tempodelay.hpp
+ * @brief   Tempo synchronized stereo delay engine.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ */
+
+#include "float_math.h"
+#include "biquad.hpp"
+#include "delayline.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Tempo synchronized stereo delay with filtered feedback.
+   *
+   * Delay time follows a note division of the current tempo, or a free time. Tempo is
+   * meant to be updated once per block, e.g.: with fx_get_bpmf(), and delay time changes
+   * crossfade between two read heads rather than sliding a single head, so the delayed
+   * signal is never pitch shifted.
+   *
+   * Typical delfx use:
+   * @code
+   * static __sdram f32pair_t s_delay_ram[1U<<17];
+   * static dsp::TempoDelay s_delay;
+   *
+   * void DELFX_INIT(uint32_t platform, uint32_t api) {
+   *   s_delay.init(s_delay_ram, 1U<<17, 48000.f);
+   * }
+   *
+   * void DELFX_PROCESS(float *xn, uint32_t frames) {
+   *   s_delay.setTempo(fx_get_bpmf());
+   *   s_delay.process(xn, frames);
+   * }
+   * @endcode
+   */
+  struct TempoDelay {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    /**
+     * Note divisions, shortest to longest
+     */
+    enum Division {
+      k_division_1_32 = 0,
+      k_division_1_16t,
+      k_division_1_16,
+      k_division_1_8t,
+      k_division_1_16d,
+      k_division_1_8,
+      k_division_1_4t,
+      k_division_1_8d,
+      k_division_1_4,
+      k_division_1_2t,
+      k_division_1_4d,
+      k_division_1_2,
+      k_division_1_1t,
+      k_division_1_2d,
+      k_division_1_1,
+      k_division_count
+    };
+
+    /**
+     * Length of each division in quarter notes
+     */
+    static inline const float * divisionBeats(void) {
+      static const float beats[k_division_count] = {
+        0.125f, 0.16666667f, 0.25f, 0.33333333f, 0.375f, 0.5f, 0.66666667f, 0.75f,
+        1.f, 1.33333333f, 1.5f, 2.f, 2.66666667f, 3.f, 4.f
+      };
+      return beats;
+    }
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    TempoDelay(void) :
+      mFs(48000.f),
+      mBpm(120.f),
+      mTime(0.5f),
+      mDivision(k_division_1_8),
+      mSynced(true),
+      mPingPong(false),
+      mFeedback(0.3f),
+      mDry(1.f),
+      mWet(0.5f),
+      mTarget(0.f),
+      mFade(0.f),
+      mFadeInc(0.f),
+      mActive(0)
+    {
+      mDelay[0] = mDelay[1] = 0.f;
+      for (uint32_t i = 0; i < 2; ++i) {
+        mLowPass[i].mCoeffs.ff0 = 1.f;
+        mHighPass[i].mCoeffs.ff0 = 1.f;
+      }
+    }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Initialize with backing memory and sampling rate
+     *
+     * @param ram Delay memory
+     * @param line_size Size in float pairs of delay memory, power of two
+     * @param fs Sampling frequency in Hz
+     * @param fade_time Duration of read head crossfades in seconds
+     */
+    inline void init(f32pair_t *ram, size_t line_size, const float fs, const float fade_time = 0.04f) {
+      mLine.setMemory(ram, line_size);
+      mLine.clear();
+      mFs = fs;
+      mFadeInc = 1.f / (fade_time * fs);
+      mFade = 0.f;
+      mActive = 0;
+      mDelay[0] = mDelay[1] = mTarget = targetDelay();
+      for (uint32_t i = 0; i < 2; ++i) {
+        mLowPass[i].flush();
+        mHighPass[i].flush();
+      }
+    }
+
+    /**
+     * Clear delay memory and filter states
+     */
+    inline void clear(void) {
+      mLine.clear();
+      for (uint32_t i = 0; i < 2; ++i) {
+        mLowPass[i].flush();
+        mHighPass[i].flush();
+      }
+    }
+
+    /**
+     * Set tempo
+     *
+     * @param bpm Beats per minute, e.g.: fx_get_bpmf()
+     */
+    inline void setTempo(const float bpm) {
+      mBpm = clipminf(1.f, bpm);
+      retarget();
+    }
+
+    /**
+     * Sync delay time to a note division of the tempo
+     *
+     * @param div Note division
+     */
+    inline void setDivision(const Division div) {
+      mDivision = (div < k_division_count) ? div : k_division_1_1;
+      mSynced = true;
+      retarget();
+    }
+
+    /**
+     * Set free running delay time, disabling tempo sync
+     *
+     * @param seconds Delay time in seconds
+     */
+    inline void setTime(const float seconds) {
+      mTime = seconds;
+      mSynced = false;
+      retarget();
+    }
+
+    /**
+     * Set feedback amount
+     *
+     * @param fb Feedback gain in [0, 1)
+     */
+    inline void setFeedback(const float fb) {
+      mFeedback = clipminmaxf(0.f, fb, 0.99f);
+    }
+
+    /**
+     * Set dry and wet output levels
+     */
+    inline void setMix(const float dry, const float wet) {
+      mDry = dry;
+      mWet = wet;
+    }
+
+    /**
+     * Enable cross feedback between channels
+     */
+    inline void setPingPong(const bool pingpong) {
+      mPingPong = pingpong;
+    }
+
+    /**
+     * Set feedback path filters
+     *
+     * @param lp_k Low pass cutoff as tan(pi*wc), e.g.: fx_tanpif(wc)
+     * @param hp_k High pass cutoff as tan(pi*wc), e.g.: fx_tanpif(wc)
+     */
+    inline void setFilters(const float lp_k, const float hp_k) {
+      mLowPass[0].mCoeffs.setSOLP(lp_k, 0.70710678f);
+      mHighPass[0].mCoeffs.setFOHP(hp_k);
+      mLowPass[1].mCoeffs = mLowPass[0].mCoeffs;
+      mHighPass[1].mCoeffs = mHighPass[0].mCoeffs;
+    }
+
+    /**
+     * Process a block of interleaved stereo samples in place
+     *
+     * @param xn Interleaved stereo buffer
+     * @param frames Number of stereo frames
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(float * xn, const uint32_t frames) {
+      uint32_t done = 0;
+      // Run crossfading path only until the fade completes
+      while (done < frames && mFade > 0.f) {
+        const uint32_t left = (uint32_t)((1.f - mFade) / mFadeInc) + 1;
+        const uint32_t n = (left < frames - done) ? left : frames - done;
+        render<true>(xn + 2*done, n);
+        done += n;
+        if (mFade >= 1.f)
+          finishFade();
+      }
+      if (done < frames)
+        render<false>(xn + 2*done, frames - done);
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /** @private */
+    inline float targetDelay(void) const {
+      const float seconds = (mSynced) ? divisionBeats()[mDivision] * 60.f / mBpm : mTime;
+      // Reads happen before writes, keep room for interpolation
+      return clipminmaxf(1.f, seconds * mFs, (float)(mLine.mSize - 2));
+    }
+
+    /** @private */
+    inline void retarget(void) {
+      mTarget = targetDelay();
+      if (mFade == 0.f && si_fabsf(mTarget - mDelay[mActive]) >= 1.f) {
+        // Start reading from new position on idle head
+        mDelay[mActive ^ 1] = mTarget;
+        mFade = mFadeInc;
+      }
+    }
+
+    /** @private */
+    inline void finishFade(void) {
+      mActive ^= 1;
+      mFade = 0.f;
+      // Pick up changes that happened during the fade
+      retarget();
+    }
+
+    /** @private */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    f32pair_t readHead(const uint32_t base, const float frac) {
+      return f32pair_linint(frac, mLine.read(base), mLine.read(base + 1));
+    }
+
+    /** @private */
+    template <bool fading>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void render(float * xn, const uint32_t frames) {
+      const float d0 = mDelay[mActive];
+      const uint32_t base0 = (uint32_t)d0;
+      const float frac0 = d0 - base0;
+      const float d1 = mDelay[mActive ^ 1];
+      const uint32_t base1 = (uint32_t)d1;
+      const float frac1 = d1 - base1;
+
+      const float fb = mFeedback;
+      const float dry = mDry;
+      const float wet = mWet;
+      const bool pingpong = mPingPong;
+      float fade = mFade;
+      const float fade_inc = mFadeInc;
+
+      const float * xn_e = xn + 2*frames;
+      for (; xn != xn_e; xn += 2) {
+        f32pair_t y = readHead(base0, frac0);
+        if (fading) {
+          // Smoothstep crossfade, gains sum to one since both heads read the same
+          // (correlated) signal and any bump would be fed back into the line
+          const f32pair_t y1 = readHead(base1, frac1);
+          const float g1 = fade * fade * (3.f - 2.f * fade);
+          y = f32pair_add(f32pair_mulscal(y, 1.f - g1), f32pair_mulscal(y1, g1));
+          fade = clipmaxf(fade + fade_inc, 1.f);
+        }
+
+        float fb0 = mHighPass[0].process_fo(mLowPass[0].process_so(y.a));
+        float fb1 = mHighPass[1].process_fo(mLowPass[1].process_so(y.b));
+        if (pingpong) {
+          const float t = fb0;
+          fb0 = fb1;
+          fb1 = t;
+        }
+
+        const float in0 = xn[0];
+        const float in1 = xn[1];
+        mLine.write(f32pair(in0 + fb * fb0, in1 + fb * fb1));
+        xn[0] = dry * in0 + wet * y.a;
+        xn[1] = dry * in1 + wet * y.b;
+      }
+
+      if (fading)
+        mFade = fade;
+    }
+
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    DualDelayLine mLine;
+    BiQuad        mLowPass[2];
+    BiQuad        mHighPass[2];
+    float         mFs;
+    float         mBpm;
+    float         mTime;
+    Division      mDivision;
+    bool          mSynced;
+    bool          mPingPong;
+    float         mFeedback;
+    float         mDry;
+    float         mWet;
+    float         mTarget;
+    float         mDelay[2];
+    float         mFade;
+    float         mFadeInc;
+    uint32_t      mActive;
+  };
+}
+
+/** @} */
@@ -0,0 +1,209 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    timbrepair.hpp
+ * @brief   Joint main and sub timbre processing for modulation effects.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include "float_math.h"
+#include "buffer_ops.h"
+#include "silence.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Runs one effect graph over main and sub timbres in a single pass.
+   *
+   * Sample pairs hold the main timbre in lane a and the sub timbre in lane b, so graphs
+   * built from pair primitives such as PairBiQuad or DualDelayLine process both timbres
+   * with shared coefficients and addressing. When the sub timbre has been silent for
+   * longer than the effect tail, only the main timbre is processed and the sub output is
+   * cleared, so single timbre patches cost about the same as a mono timbre effect.
+   *
+   * The graph must provide:
+   * @code
+   * struct MyGraph {
+   *   // Both timbres, l/r as (main, sub) pairs
+   *   void process(f32pair_t &l, f32pair_t &r);
+   *   // Main timbre only, sub timbre state left untouched
+   *   void process_a(float &l, float &r);
+   *   // Clear sub timbre state
+   *   void flush_b(void);
+   * };
+   *
+   * static dsp::TimbrePair<MyGraph> s_fx;
+   *
+   * void MODFX_INIT(uint32_t platform, uint32_t api) {
+   *   s_fx.setSubEnabled((platform & 0xFF00) == k_user_target_prologue);
+   *   s_fx.setTail(k_samplerate / 2);
+   * }
+   *
+   * void MODFX_PROCESS(const float *main_xn, float *main_yn,
+   *                    const float *sub_xn,  float *sub_yn,
+   *                    uint32_t frames) {
+   *   s_fx.process(main_xn, main_yn, sub_xn, sub_yn, frames);
+   * }
+   * @endcode
+   *
+   * @tparam Graph Effect graph type
+   */
+  template <class Graph>
+  struct TimbrePair {
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    TimbrePair(void) :
+      mTail(0),
+      mSubQuiet(0),
+      mSubEnabled(true),
+      mSubActive(false)
+    { }
+
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Enable sub timbre processing, only prologue has a sub timbre
+     */
+    inline void setSubEnabled(const bool enabled) {
+      mSubEnabled = enabled;
+      if (!enabled)
+        bypassSub();
+    }
+
+    /**
+     * Set duration the effect keeps producing output after its input went silent
+     *
+     * @param frames Tail length in frames
+     */
+    inline void setTail(const uint32_t frames) {
+      mTail = frames;
+    }
+
+    /**
+     * Whether the sub timbre is currently processed
+     */
+    inline bool isSubActive(void) const {
+      return mSubActive;
+    }
+
+    /**
+     * Process main and sub timbre interleaved stereo buffers
+     *
+     * @param main_xn Main timbre input
+     * @param main_yn Main timbre output, can be the same as input
+     * @param sub_xn Sub timbre input
+     * @param sub_yn Sub timbre output, can be the same as input
+     * @param frames Number of stereo frames
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(const float * main_xn, float * main_yn,
+                 const float * sub_xn, float * sub_yn,
+                 const uint32_t frames) {
+      if (mSubEnabled) {
+        if (!buf_is_silent(sub_xn, 2 * frames)) {
+          mSubQuiet = 0;
+          mSubActive = true;
+        }
+        else if (mSubActive) {
+          mSubQuiet += frames;
+          if (mSubQuiet > mTail)
+            bypassSub();
+        }
+      }
+
+      if (mSubActive) {
+        const float * xn_e = main_xn + 2 * frames;
+        for (; main_xn != xn_e; main_xn += 2, sub_xn += 2, main_yn += 2, sub_yn += 2) {
+          f32pair_t l = f32pair(main_xn[0], sub_xn[0]);
+          f32pair_t r = f32pair(main_xn[1], sub_xn[1]);
+          mGraph.process(l, r);
+          main_yn[0] = l.a;
+          main_yn[1] = r.a;
+          sub_yn[0] = l.b;
+          sub_yn[1] = r.b;
+        }
+      }
+      else {
+        const float * xn_e = main_xn + 2 * frames;
+        for (; main_xn != xn_e; main_xn += 2, main_yn += 2) {
+          float l = main_xn[0];
+          float r = main_xn[1];
+          mGraph.process_a(l, r);
+          main_yn[0] = l;
+          main_yn[1] = r;
+        }
+        if (mSubEnabled)
+          buf_clr_f32(sub_yn, 2 * frames);
+      }
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /** @private */
+    inline void bypassSub(void) {
+      mSubActive = false;
+      mSubQuiet = 0;
+      // Sub lane restarts from clean state when it becomes audible again
+      mGraph.flush_b();
+    }
+
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    Graph    mGraph;
+    uint32_t mTail;
+    uint32_t mSubQuiet;
+    bool     mSubEnabled;
+    bool     mSubActive;
+  };
+}
+
+/** @} */
@@ -0,0 +1,111 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    waveshaper_bench.hpp
+ * @brief   Accuracy check of antiderivative anti-aliased waveshapers.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ * Drives an ADAA processor with a slow sine, where aliasing is negligible, and compares
+ * its output to the shaping function evaluated at the processor's group delay. Large
+ * errors point at numerical problems, e.g.: cancellation in antiderivative differences.
+ *
+ * Typical host harness, flagging samples off by more than 0.05:
+ * @code
+ * static const dsp::TanhShaper s_tanh;
+ * dsp::ADAA2<dsp::TanhShaper> adaa(s_tanh);
+ * dsp::ADAABenchResult res;
+ * dsp::benchADAA(adaa, s_tanh, 1.f, 20.f / 48000.f, 3.f, 48000, 0.05f, &res);
+ * @endcode
+ */
+
+#include "waveshaper.hpp"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Results of benchADAA()
+   */
+  typedef struct ADAABenchResult {
+    float max_err;     /**< Maximum absolute error against the delayed shaping function */
+    float max_at;      /**< Input value at maximum error */
+    uint32_t outliers; /**< Number of samples with error above tolerance */
+  } ADAABenchResult;
+
+  /**
+   * Measure ADAA output error on a sine input
+   *
+   * @param adaa Processor, e.g.: ADAA1 or ADAA2, flushed before use
+   * @param shaper Shaping function used by the processor
+   * @param delay Processor group delay in samples, 0.5 for ADAA1 and 1 for ADAA2
+   * @param w Sine frequency relative to sampling rate, i.e.: f0 / Fs
+   * @param amp Sine amplitude
+   * @param frames Number of samples to process
+   * @param tolerance Error above which a sample counts as an outlier
+   * @param res Results
+   */
+  template <typename Processor, typename Shaper>
+  inline void benchADAA(Processor &adaa, const Shaper &shaper, const float delay, const float w,
+                        const float amp, const uint32_t frames, const float tolerance,
+                        ADAABenchResult *res) {
+    adaa.flush();
+    float max_err = 0.f;
+    float max_at = 0.f;
+    uint32_t outliers = 0;
+    for (uint32_t n = 0; n < frames; ++n) {
+      // Phases kept in double so that the reference is not limited by phase resolution
+      const float y = adaa.process(amp * (float)sin(2.0 * M_PI * w * n));
+      if (n < 2)
+        continue;
+      const float xd = amp * (float)sin(2.0 * M_PI * w * (n - delay));
+      const float err = si_fabsf(y - shaper.f0(xd));
+      if (err > tolerance)
+        ++outliers;
+      if (err > max_err) {
+        max_err = err;
+        max_at = xd;
+      }
+    }
+    res->max_err = max_err;
+    res->max_at = max_at;
+    res->outliers = outliers;
+  }
+}
+
+/** @} */
@@ -0,0 +1,279 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    waveshaper_lut.h
+ * @brief   Precomputed shaping curves and antiderivatives for waveshaper.hpp.
+ *
+ * Antiderivatives are integrated in double precision from the linear interpolation of
+ * the sampled curve, matching the lookups done by dsp::ShaperTable.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ *
+ */
+
+#define k_shaper_size_exp   (7)
+#define k_shaper_size       (1U<<k_shaper_size_exp)
+#define k_shaper_lut_size   (k_shaper_size+1)
+
+#define k_tanh_shaper_range  (4.f)
+#define k_cubic_shaper_range (1.f)
+
+namespace dsp {
+
+  /** Shaping function, tanh(x) on [0, 4] */
+  static const float tanh_shaper_lut_f[k_shaper_lut_size] = {
+    0.000000000e+00f, 3.123983145e-02f, 6.241874675e-02f, 9.347630397e-02f,
+    1.243530018e-01f, 1.549907304e-01f, 1.853331999e-01f, 2.153263397e-01f,
+    2.449186624e-01f, 2.740615890e-01f, 3.027097293e-01f, 3.308211175e-01f,
+    3.583573984e-01f, 3.852839663e-01f, 4.115700557e-01f, 4.371887851e-01f,
+    4.621171573e-01f, 4.863360172e-01f, 5.098299737e-01f, 5.325872862e-01f,
+    5.545997223e-01f, 5.758623913e-01f, 5.963735555e-01f, 6.161344271e-01f,
+    6.351489524e-01f, 6.534235881e-01f, 6.709670742e-01f, 6.877902051e-01f,
+    7.039056039e-01f, 7.193275010e-01f, 7.340715196e-01f, 7.481544703e-01f,
+    7.615941560e-01f, 7.744091874e-01f, 7.866188121e-01f, 7.982427545e-01f,
+    8.093010702e-01f, 8.198140121e-01f, 8.298019100e-01f, 8.392850624e-01f,
+    8.482836400e-01f, 8.568176011e-01f, 8.649066177e-01f, 8.725700115e-01f,
+    8.798266997e-01f, 8.866951494e-01f, 8.931933404e-01f, 8.993387348e-01f,
+    9.051482536e-01f, 9.106382595e-01f, 9.158245442e-01f, 9.207223218e-01f,
+    9.253462253e-01f, 9.297103072e-01f, 9.338280432e-01f, 9.377123389e-01f,
+    9.413755385e-01f, 9.448294355e-01f, 9.480852856e-01f, 9.511538199e-01f,
+    9.540452602e-01f, 9.567693345e-01f, 9.593352933e-01f, 9.617519265e-01f,
+    9.640275801e-01f, 9.661701735e-01f, 9.681872166e-01f, 9.700858268e-01f,
+    9.718727459e-01f, 9.735543565e-01f, 9.751366983e-01f, 9.766254840e-01f,
+    9.780261147e-01f, 9.793436950e-01f, 9.805830470e-01f, 9.817487252e-01f,
+    9.828450292e-01f, 9.838760169e-01f, 9.848455175e-01f, 9.857571425e-01f,
+    9.866142982e-01f, 9.874201957e-01f, 9.881778623e-01f, 9.888901506e-01f,
+    9.895597486e-01f, 9.901891886e-01f, 9.907808556e-01f, 9.913369960e-01f,
+    9.918597246e-01f, 9.923510327e-01f, 9.928127948e-01f, 9.932467752e-01f,
+    9.936546343e-01f, 9.940379345e-01f, 9.943981461e-01f, 9.947366521e-01f,
+    9.950547537e-01f, 9.953536750e-01f, 9.956345671e-01f, 9.958985129e-01f,
+    9.961465307e-01f, 9.963795779e-01f, 9.965985552e-01f, 9.968043090e-01f,
+    9.969976355e-01f, 9.971792830e-01f, 9.973499552e-01f, 9.975103134e-01f,
+    9.976609795e-01f, 9.978025379e-01f, 9.979355379e-01f, 9.980604961e-01f,
+    9.981778976e-01f, 9.982881987e-01f, 9.983918281e-01f, 9.984891887e-01f,
+    9.985806592e-01f, 9.986665954e-01f, 9.987473317e-01f, 9.988231824e-01f,
+    9.988944427e-01f, 9.989613903e-01f, 9.990242858e-01f, 9.990833742e-01f,
+    9.991388858e-01f, 9.991910370e-01f, 9.992400310e-01f, 9.992860587e-01f,
+    9.993292997e-01f
+  };
+
+  /** First antiderivative of tanh_shaper_lut_f */
+  static const float tanh_shaper_int1_lut_f[k_shaper_lut_size] = {
+    0.000000000e+00f, 4.881223663e-04f, 1.951537651e-03f, 4.387397818e-03f,
+    7.790980720e-03f, 1.215572654e-02f, 1.747328795e-02f, 2.373359325e-02f,
+    3.092492141e-02f, 3.903398784e-02f, 4.804603968e-02f, 5.794495917e-02f,
+    6.871337348e-02f, 8.033276980e-02f, 9.278361389e-02f, 1.060454708e-01f,
+    1.200971261e-01f, 1.349167070e-01f, 1.504818006e-01f, 1.667695703e-01f,
+    1.837568673e-01f, 2.014203378e-01f, 2.197365245e-01f, 2.386819617e-01f,
+    2.582332645e-01f, 2.783672105e-01f, 2.990608146e-01f, 3.202913970e-01f,
+    3.420366441e-01f, 3.642746613e-01f, 3.869840210e-01f, 4.101438021e-01f,
+    4.337336244e-01f, 4.577336766e-01f, 4.821247391e-01f, 5.068882011e-01f,
+    5.320060734e-01f, 5.574609965e-01f, 5.832362453e-01f, 6.093157293e-01f,
+    6.356839902e-01f, 6.623261971e-01f, 6.892281380e-01f, 7.163762104e-01f,
+    7.437574090e-01f, 7.713593129e-01f, 7.991700705e-01f, 8.271783842e-01f,
+    8.553734934e-01f, 8.837451577e-01f, 9.122836390e-01f, 9.409796838e-01f,
+    9.698245048e-01f, 9.988097631e-01f, 1.027927550e+00f, 1.057170368e+00f,
+    1.086531116e+00f, 1.116003069e+00f, 1.145579862e+00f, 1.175255473e+00f,
+    1.205024208e+00f, 1.234880686e+00f, 1.264819821e+00f, 1.294836809e+00f,
+    1.324927114e+00f, 1.355086454e+00f, 1.385310788e+00f, 1.415596304e+00f,
+    1.445939407e+00f, 1.476336705e+00f, 1.506785003e+00f, 1.537281287e+00f,
+    1.567822718e+00f, 1.598406622e+00f, 1.629030477e+00f, 1.659691911e+00f,
+    1.690388688e+00f, 1.721118705e+00f, 1.751879979e+00f, 1.782670645e+00f,
+    1.813488949e+00f, 1.844333238e+00f, 1.875201958e+00f, 1.906093645e+00f,
+    1.937006925e+00f, 1.967940502e+00f, 1.998893159e+00f, 2.029863751e+00f,
+    2.060851199e+00f, 2.091854492e+00f, 2.122872677e+00f, 2.153904858e+00f,
+    2.184950192e+00f, 2.216007889e+00f, 2.247077203e+00f, 2.278157434e+00f,
+    2.309247925e+00f, 2.340348056e+00f, 2.371457248e+00f, 2.402574952e+00f,
+    2.433700656e+00f, 2.464833876e+00f, 2.495974160e+00f, 2.527121079e+00f,
+    2.558274235e+00f, 2.589433249e+00f, 2.620597768e+00f, 2.651767460e+00f,
+    2.682942011e+00f, 2.714121129e+00f, 2.745304536e+00f, 2.776491974e+00f,
+    2.807683199e+00f, 2.838877982e+00f, 2.870076107e+00f, 2.901277373e+00f,
+    2.932481590e+00f, 2.963688578e+00f, 2.994898171e+00f, 3.026110210e+00f,
+    3.057324548e+00f, 3.088541045e+00f, 3.119759571e+00f, 3.150980004e+00f,
+    3.182202226e+00f, 3.213426132e+00f, 3.244651617e+00f, 3.275878587e+00f,
+    3.307106952e+00f
+  };
+
+  /** Second antiderivative of tanh_shaper_lut_f */
+  static const float tanh_shaper_int2_lut_f[k_shaper_lut_size] = {
+    0.000000000e+00f, 5.084607983e-06f, 4.066694912e-05f, 1.371853453e-04f,
+    3.249597579e-04f, 6.341337540e-04f, 1.094617829e-03f, 1.736034500e-03f,
+    2.587665562e-03f, 3.678401861e-03f, 5.036695900e-03f, 6.690517546e-03f,
+    8.667313085e-03f, 1.099396778e-02f, 1.369677211e-02f, 1.680139170e-02f,
+    2.033284110e-02f, 2.431546131e-02f, 2.877290105e-02f, 3.372810172e-02f,
+    3.920328593e-02f, 4.521994940e-02f, 5.179885617e-02f, 5.896003687e-02f,
+    6.672278988e-02f, 7.510568511e-02f, 8.412657030e-02f, 9.380257954e-02f,
+    1.041501437e-01f, 1.151850028e-01f, 1.269222199e-01f, 1.393761960e-01f,
+    1.525606871e-01f, 1.664888208e-01f, 1.811731149e-01f, 1.966254961e-01f,
+    2.128573192e-01f, 2.298793867e-01f, 2.477019683e-01f, 2.663348211e-01f,
+    2.857872094e-01f, 3.060679241e-01f, 3.271853023e-01f, 3.491472466e-01f,
+    3.719612439e-01f, 3.956343837e-01f, 4.201733765e-01f, 4.455845710e-01f,
+    4.718739713e-01f, 4.990472534e-01f, 5.271097813e-01f, 5.560666221e-01f,
+    5.859225613e-01f, 6.166821166e-01f, 6.483495520e-01f, 6.809288909e-01f,
+    7.144239284e-01f, 7.488382440e-01f, 7.841752123e-01f, 8.204380147e-01f,
+    8.576296494e-01f, 8.957529417e-01f, 9.348105533e-01f, 9.748049915e-01f,
+    1.015738618e+00f, 1.057613655e+00f, 1.100432198e+00f, 1.144196217e+00f,
+    1.188907567e+00f, 1.234567994e+00f, 1.281179142e+00f, 1.328742557e+00f,
+    1.377259693e+00f, 1.426731919e+00f, 1.477160523e+00f, 1.528546715e+00f,
+    1.580891636e+00f, 1.634196355e+00f, 1.688461880e+00f, 1.743689159e+00f,
+    1.799879083e+00f, 1.857032489e+00f, 1.915150165e+00f, 1.974232851e+00f,
+    2.034281243e+00f, 2.095295995e+00f, 2.157277723e+00f, 2.220227005e+00f,
+    2.284144383e+00f, 2.349030370e+00f, 2.414885444e+00f, 2.481710058e+00f,
+    2.549504635e+00f, 2.618269574e+00f, 2.688005249e+00f, 2.758712012e+00f,
+    2.830390195e+00f, 2.903040108e+00f, 2.976662043e+00f, 3.051256275e+00f,
+    3.126823061e+00f, 3.203362644e+00f, 3.280875252e+00f, 3.359361098e+00f,
+    3.438820384e+00f, 3.519253299e+00f, 3.600660020e+00f, 3.683040713e+00f,
+    3.766395536e+00f, 3.850724637e+00f, 3.936028152e+00f, 4.022306212e+00f,
+    4.109558940e+00f, 4.197786449e+00f, 4.286988848e+00f, 4.377166238e+00f,
+    4.468318715e+00f, 4.560446367e+00f, 4.653549278e+00f, 4.747627528e+00f,
+    4.842681190e+00f, 4.938710335e+00f, 5.035715027e+00f, 5.133695328e+00f,
+    5.232651296e+00f, 5.332582984e+00f, 5.433490445e+00f, 5.535373726e+00f,
+    5.638232871e+00f
+  };
+
+  /** Shaping function, 1.5x - 0.5x^3 on [0, 1] */
+  static const float cubic_shaper_lut_f[k_shaper_lut_size] = {
+    0.000000000e+00f, 1.171851158e-02f, 2.343559265e-02f, 3.514981270e-02f,
+    4.685974121e-02f, 5.856394768e-02f, 7.026100159e-02f, 8.194947243e-02f,
+    9.362792969e-02f, 1.052949429e-01f, 1.169490814e-01f, 1.285889149e-01f,
+    1.402130127e-01f, 1.518199444e-01f, 1.634082794e-01f, 1.749765873e-01f,
+    1.865234375e-01f, 1.980473995e-01f, 2.095470428e-01f, 2.210209370e-01f,
+    2.324676514e-01f, 2.438857555e-01f, 2.552738190e-01f, 2.666304111e-01f,
+    2.779541016e-01f, 2.892434597e-01f, 3.004970551e-01f, 3.117134571e-01f,
+    3.228912354e-01f, 3.340289593e-01f, 3.451251984e-01f, 3.561785221e-01f,
+    3.671875000e-01f, 3.781507015e-01f, 3.890666962e-01f, 3.999340534e-01f,
+    4.107513428e-01f, 4.215171337e-01f, 4.322299957e-01f, 4.428884983e-01f,
+    4.534912109e-01f, 4.640367031e-01f, 4.745235443e-01f, 4.849503040e-01f,
+    4.953155518e-01f, 5.056178570e-01f, 5.158557892e-01f, 5.260279179e-01f,
+    5.361328125e-01f, 5.461690426e-01f, 5.561351776e-01f, 5.660297871e-01f,
+    5.758514404e-01f, 5.855987072e-01f, 5.952701569e-01f, 6.048643589e-01f,
+    6.143798828e-01f, 6.238152981e-01f, 6.331691742e-01f, 6.424400806e-01f,
+    6.516265869e-01f, 6.607272625e-01f, 6.697406769e-01f, 6.786653996e-01f,
+    6.875000000e-01f, 6.962430477e-01f, 7.048931122e-01f, 7.134487629e-01f,
+    7.219085693e-01f, 7.302711010e-01f, 7.385349274e-01f, 7.466986179e-01f,
+    7.547607422e-01f, 7.627198696e-01f, 7.705745697e-01f, 7.783234119e-01f,
+    7.859649658e-01f, 7.934978008e-01f, 8.009204865e-01f, 8.082315922e-01f,
+    8.154296875e-01f, 8.225133419e-01f, 8.294811249e-01f, 8.363316059e-01f,
+    8.430633545e-01f, 8.496749401e-01f, 8.561649323e-01f, 8.625319004e-01f,
+    8.687744141e-01f, 8.748910427e-01f, 8.808803558e-01f, 8.867409229e-01f,
+    8.924713135e-01f, 8.980700970e-01f, 9.035358429e-01f, 9.088671207e-01f,
+    9.140625000e-01f, 9.191205502e-01f, 9.240398407e-01f, 9.288189411e-01f,
+    9.334564209e-01f, 9.379508495e-01f, 9.423007965e-01f, 9.465048313e-01f,
+    9.505615234e-01f, 9.544694424e-01f, 9.582271576e-01f, 9.618332386e-01f,
+    9.652862549e-01f, 9.685847759e-01f, 9.717273712e-01f, 9.747126102e-01f,
+    9.775390625e-01f, 9.802052975e-01f, 9.827098846e-01f, 9.850513935e-01f,
+    9.872283936e-01f, 9.892394543e-01f, 9.910831451e-01f, 9.927580357e-01f,
+    9.942626953e-01f, 9.955956936e-01f, 9.967556000e-01f, 9.977409840e-01f,
+    9.985504150e-01f, 9.991824627e-01f, 9.996356964e-01f, 9.999086857e-01f,
+    1.000000000e+00f
+  };
+
+  /** First antiderivative of cubic_shaper_lut_f */
+  static const float cubic_shaper_int1_lut_f[k_shaper_lut_size] = {
+    0.000000000e+00f, 4.577543586e-05f, 1.830961555e-04f, 4.119453952e-04f,
+    7.322952151e-04f, 1.144106500e-03f, 1.647328958e-03f, 2.241901122e-03f,
+    2.927750349e-03f, 3.704792820e-03f, 4.572933540e-03f, 5.532066338e-03f,
+    6.582073867e-03f, 7.722827606e-03f, 8.954187855e-03f, 1.027600374e-02f,
+    1.168811321e-02f, 1.319034304e-02f, 1.478250884e-02f, 1.646441501e-02f,
+    1.823585480e-02f, 2.009661030e-02f, 2.204645239e-02f, 2.408514079e-02f,
+    2.621242404e-02f, 2.842803951e-02f, 3.073171340e-02f, 3.312316071e-02f,
+    3.560208529e-02f, 3.816817980e-02f, 4.082112573e-02f, 4.356059339e-02f,
+    4.638624191e-02f, 4.929771926e-02f, 5.229466222e-02f, 5.537669640e-02f,
+    5.854343623e-02f, 6.179448497e-02f, 6.512943469e-02f, 6.854786631e-02f,
+    7.204934955e-02f, 7.563344296e-02f, 7.929969393e-02f, 8.304763865e-02f,
+    8.687680215e-02f, 9.078669827e-02f, 9.477682970e-02f, 9.884668794e-02f,
+    1.029957533e-01f, 1.072234949e-01f, 1.115293708e-01f, 1.159128277e-01f,
+    1.203733012e-01f, 1.249102158e-01f, 1.295229848e-01f, 1.342110103e-01f,
+    1.389736831e-01f, 1.438103830e-01f, 1.487204786e-01f, 1.537033273e-01f,
+    1.587582752e-01f, 1.638846574e-01f, 1.690817978e-01f, 1.743490091e-01f,
+    1.796855927e-01f, 1.850908389e-01f, 1.905640271e-01f, 1.961044250e-01f,
+    2.017112896e-01f, 2.073838664e-01f, 2.131213900e-01f, 2.189230835e-01f,
+    2.247881591e-01f, 2.307158178e-01f, 2.367052492e-01f, 2.427556319e-01f,
+    2.488661334e-01f, 2.550359098e-01f, 2.612641063e-01f, 2.675498566e-01f,
+    2.738922834e-01f, 2.802904984e-01f, 2.867436018e-01f, 2.932506828e-01f,
+    2.998108193e-01f, 3.064230783e-01f, 3.130865153e-01f, 3.198001748e-01f,
+    3.265630901e-01f, 3.333742833e-01f, 3.402327653e-01f, 3.471375359e-01f,
+    3.540875837e-01f, 3.610818861e-01f, 3.681194093e-01f, 3.751991084e-01f,
+    3.823199272e-01f, 3.894807985e-01f, 3.966806438e-01f, 4.039183734e-01f,
+    4.111928865e-01f, 4.185030712e-01f, 4.258478042e-01f, 4.332259512e-01f,
+    4.406363666e-01f, 4.480778938e-01f, 4.555493649e-01f, 4.630496008e-01f,
+    4.705774114e-01f, 4.781315951e-01f, 4.857109394e-01f, 4.933142206e-01f,
+    5.009402037e-01f, 5.085876426e-01f, 5.162552800e-01f, 5.239418475e-01f,
+    5.316460654e-01f, 5.393666429e-01f, 5.471022781e-01f, 5.548516577e-01f,
+    5.626134574e-01f, 5.703863418e-01f, 5.781689640e-01f, 5.859599663e-01f,
+    5.937579796e-01f, 6.015616236e-01f, 6.093695071e-01f, 6.171802273e-01f,
+    6.249923706e-01f
+  };
+
+  /** Second antiderivative of cubic_shaper_lut_f */
+  static const float cubic_shaper_int2_lut_f[k_shaper_lut_size] = {
+    0.000000000e+00f, 1.192068642e-07f, 9.536403619e-07f, 3.218439815e-06f,
+    7.628569923e-06f, 1.489873345e-05f, 2.574328391e-05f, 4.087613828e-05f,
+    6.101068963e-05f, 8.685971989e-05f, 1.191353125e-04f, 1.585487650e-04f,
+    2.058105019e-04f, 2.616299874e-04f, 3.267156377e-04f, 4.017747342e-04f,
+    4.875133357e-04f, 5.846361916e-04f, 6.938466540e-04f, 8.158465910e-04f,
+    9.513362990e-04f, 1.101014415e-03f, 1.265577831e-03f, 1.445721604e-03f,
+    1.642138872e-03f, 1.855520762e-03f, 2.086556308e-03f, 2.335932360e-03f,
+    2.604333500e-03f, 2.892441948e-03f, 3.200937485e-03f, 3.530497355e-03f,
+    3.881796186e-03f, 4.255505897e-03f, 4.652295616e-03f, 5.072831586e-03f,
+    5.517777085e-03f, 5.987792332e-03f, 6.483534404e-03f, 7.005657149e-03f,
+    7.554811096e-03f, 8.131643367e-03f, 8.736797594e-03f, 9.370913829e-03f,
+    1.003462845e-02f, 1.072857410e-02f, 1.145337956e-02f, 1.220966969e-02f,
+    1.299806533e-02f, 1.381918322e-02f, 1.467363591e-02f, 1.556203167e-02f,
+    1.648497441e-02f, 1.744306357e-02f, 1.843689407e-02f, 1.946705619e-02f,
+    2.053413550e-02f, 2.163871277e-02f, 2.278136387e-02f, 2.396265971e-02f,
+    2.518316612e-02f, 2.644344378e-02f, 2.774404815e-02f, 2.908552935e-02f,
+    3.046843208e-02f, 3.189329554e-02f, 3.336065337e-02f, 3.487103349e-02f,
+    3.642495810e-02f, 3.802294352e-02f, 3.966550014e-02f, 4.135313235e-02f,
+    4.308633838e-02f, 4.486561031e-02f, 4.669143390e-02f, 4.856428855e-02f,
+    5.048464721e-02f, 5.245297625e-02f, 5.446973543e-02f, 5.653537779e-02f,
+    5.865034954e-02f, 6.081509000e-02f, 6.303003151e-02f, 6.529559935e-02f,
+    6.761221160e-02f, 6.998027913e-02f, 7.240020547e-02f, 7.487238672e-02f,
+    7.739721147e-02f, 7.997506073e-02f, 8.260630780e-02f, 8.529131823e-02f,
+    8.803044971e-02f, 9.082405197e-02f, 9.367246673e-02f, 9.657602757e-02f,
+    9.953505988e-02f, 1.025498807e-01f, 1.056207989e-01f, 1.087481145e-01f,
+    1.119321192e-01f, 1.151730962e-01f, 1.184713197e-01f, 1.218270552e-01f,
+    1.252405592e-01f, 1.287120794e-01f, 1.322418543e-01f, 1.358301131e-01f,
+    1.394770761e-01f, 1.431829539e-01f, 1.469479478e-01f, 1.507722496e-01f,
+    1.546560416e-01f, 1.585994962e-01f, 1.626027761e-01f, 1.666660342e-01f,
+    1.707894135e-01f, 1.749730466e-01f, 1.792170565e-01f, 1.835215555e-01f,
+    1.878866460e-01f, 1.923124196e-01f, 1.967989579e-01f, 2.013463315e-01f,
+    2.059546006e-01f, 2.106238146e-01f, 2.153540120e-01f, 2.201452206e-01f,
+    2.249974568e-01f
+  };
+}
+
+/** @} */
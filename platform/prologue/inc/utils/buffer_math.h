@@ -0,0 +1,427 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+/**
+ * @file    buffer_math.h
+ * @brief   Buffer-wise versions of float_math.h approximations.
+ *
+ * @addtogroup utils Utils
+ * @{
+ *
+ * @addtogroup utils_buffer_math Buffer Math
+ * @{
+ *
+ * Array in, array out versions of common approximations, meant as building
+ * blocks for block based processing (e.g.: envelope exponentiation,
+ * saturation, gain conversion). Processing in place (xn == yn) is allowed.
+ *
+ * buf_fast*() and buf_faster*() compute the same approximations as the
+ * float_math.h functions of the same name, with the same valid domains.
+ * buf_tanhpadef() computes the "faster" tier of tier_tanhf() instead, since
+ * fastertanhf() is only valid for non negative inputs.
+ *
+ * Four values are processed per iteration, with NEON when available
+ * (drumlogue), otherwise as four independent scalar computations that the
+ * compiler can interleave to hide FPU latencies (Cortex-M4). Remainders are
+ * processed one value at a time with the same scalar code.
+ *
+ * Only depends on the C library so that it can be shared across platforms.
+ *
+ */
+
+#ifndef __buffer_math_h
+#define __buffer_math_h
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*=====================================================================*
+ *                                                                     *
+ *  The approximations below match the fast* and faster* functions of  *
+ *  float_math.h, adapted from FastFloat code with the following       *
+ *  disclaimer:                                                        *
+ *                                                                     *
+ *                                                                     *
+ *                   Copyright (C) 2011 Paul Mineiro                   *
+ * All rights reserved.                                                *
+ *                                                                     *
+ * Redistribution and use in source and binary forms, with             *
+ * or without modification, are permitted provided that the            *
+ * following conditions are met:                                       *
+ *                                                                     *
+ *     * Redistributions of source code must retain the                *
+ *     above copyright notice, this list of conditions and             *
+ *     the following disclaimer.                                       *
+ *                                                                     *
+ *     * Redistributions in binary form must reproduce the             *
+ *     above copyright notice, this list of conditions and             *
+ *     the following disclaimer in the documentation and/or            *
+ *     other materials provided with the distribution.                 *
+ *                                                                     *
+ *     * Neither the name of Paul Mineiro nor the names                *
+ *     of other contributors may be used to endorse or promote         *
+ *     products derived from this software without specific            *
+ *     prior written permission.                                       *
+ *                                                                     *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND              *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,         *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES               *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE             *
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER               *
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,                 *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES            *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE           *
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR                *
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF          *
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY              *
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE             *
+ * POSSIBILITY OF SUCH DAMAGE.                                         *
+ *                                                                     *
+ * Contact: Paul Mineiro <paul@mineiro.com>                            *
+ *=====================================================================*/
+
+/*===========================================================================*/
+/* Scalar Kernels.                                                           */
+/*===========================================================================*/
+
+/** @private */
+static inline __attribute__((always_inline))
+uint32_t bm_f32_bits(float x) {
+  uint32_t i;
+  memcpy(&i, &x, sizeof(i));
+  return i;
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float bm_bits_f32(uint32_t i) {
+  float x;
+  memcpy(&x, &i, sizeof(x));
+  return x;
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fastsinf(float x) {
+  const float sgn = bm_bits_f32((bm_f32_bits(x) & 0x80000000U) | 0x3F800000U);
+  const float ax = bm_bits_f32(bm_f32_bits(x) & 0x7FFFFFFFU);
+  const float qp = 1.2732395447351627f * x - 0.40528473456935109f * x * ax;
+  const float qp2 = qp * qp;
+  return 0.78444488374548933f * qp
+    + sgn * qp2 * (0.20363937680730309f + qp2 * (0.015124940802184233f - qp2 * 0.0032225901625579573f));
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fastersinf(float x) {
+  const float sgn = bm_bits_f32((bm_f32_bits(x) & 0x80000000U) | 0x3F800000U);
+  const float ax = bm_bits_f32(bm_f32_bits(x) & 0x7FFFFFFFU);
+  const float qp = 1.2732395447351627f * x - 0.40528473456935109f * x * ax;
+  return qp * (0.77633023248007499f + sgn * 0.22308510060189463f * qp);
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fastlog2f(float x) {
+  const uint32_t i = bm_f32_bits(x);
+  const float mx = bm_bits_f32((i & 0x007FFFFFU) | 0x3F000000U);
+  return (float)i * 1.1920928955078125e-7f - 124.22551499f
+    - 1.498030302f * mx - 1.72587999f / (0.3520887068f + mx);
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fasterlog2f(float x) {
+  return (float)bm_f32_bits(x) * 1.1920928955078125e-7f - 126.94269504f;
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fastpow2f(float p) {
+  const float offset = (p < 0) ? 1.f : 0.f;
+  const float clipp = (p < -126.f) ? -126.f : p;
+  const float z = clipp - (float)(int32_t)clipp + offset;
+  return bm_bits_f32((uint32_t)((1 << 23) *
+    (clipp + 121.2740575f + 27.7280233f / (4.84252568f - z) - 1.49012907f * z)));
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fasterpow2f(float p) {
+  const float clipp = (p < -126.f) ? -126.f : p;
+  return bm_bits_f32((uint32_t)((1 << 23) * (clipp + 126.94269504f)));
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_tanhpadef(float x) {
+  x = (x > 3.f) ? 3.f : (x < -3.f) ? -3.f : x;
+  const float x2 = x * x;
+  return x * (27.f + x2) / (27.f + 9.f * x2);
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fasterdbampf(float db) {
+  // fasterlog2f(10.f), as used by fasterpowf(10.f, 0.05f*db)
+  return bm_fasterpow2f(0.05f * db * 3.30730438f);
+}
+
+/** @private */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float bm_fasterampdbf(float amp) {
+  return 6.020599913279624f * bm_fasterlog2f(amp);
+}
+
+/*===========================================================================*/
+/* NEON Kernels.                                                             */
+/*===========================================================================*/
+
+#if defined(__ARM_NEON)
+
+/** @private Reciprocal estimate refined by two Newton-Raphson steps */
+static inline __attribute__((always_inline))
+float32x4_t bm_recip_q(float32x4_t x) {
+  float32x4_t r = vrecpeq_f32(x);
+  r = vmulq_f32(r, vrecpsq_f32(x, r));
+  return vmulq_f32(r, vrecpsq_f32(x, r));
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fastsinf_q(float32x4_t x) {
+  const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000U));
+  const float32x4_t sgn = vreinterpretq_f32_u32(vorrq_u32(sign, vdupq_n_u32(0x3F800000U)));
+  const float32x4_t qp = vmlsq_f32(vmulq_n_f32(x, 1.2732395447351627f),
+                                   vmulq_n_f32(x, 0.40528473456935109f), vabsq_f32(x));
+  const float32x4_t qp2 = vmulq_f32(qp, qp);
+  float32x4_t y = vmlsq_n_f32(vdupq_n_f32(0.015124940802184233f), qp2, 0.0032225901625579573f);
+  y = vmlaq_f32(vdupq_n_f32(0.20363937680730309f), qp2, y);
+  y = vmulq_f32(vmulq_f32(sgn, qp2), y);
+  return vmlaq_n_f32(y, qp, 0.78444488374548933f);
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fastersinf_q(float32x4_t x) {
+  const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000U));
+  const float32x4_t sgn = vreinterpretq_f32_u32(vorrq_u32(sign, vdupq_n_u32(0x3F800000U)));
+  const float32x4_t qp = vmlsq_f32(vmulq_n_f32(x, 1.2732395447351627f),
+                                   vmulq_n_f32(x, 0.40528473456935109f), vabsq_f32(x));
+  return vmulq_f32(qp, vmlaq_f32(vdupq_n_f32(0.77633023248007499f),
+                                 vmulq_n_f32(sgn, 0.22308510060189463f), qp));
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fastlog2f_q(float32x4_t x) {
+  const uint32x4_t i = vreinterpretq_u32_f32(x);
+  const float32x4_t mx = vreinterpretq_f32_u32(
+      vorrq_u32(vandq_u32(i, vdupq_n_u32(0x007FFFFFU)), vdupq_n_u32(0x3F000000U)));
+  float32x4_t y = vmlaq_n_f32(vdupq_n_f32(-124.22551499f), vcvtq_f32_u32(i), 1.1920928955078125e-7f);
+  y = vmlsq_n_f32(y, mx, 1.498030302f);
+  const float32x4_t d = bm_recip_q(vaddq_f32(mx, vdupq_n_f32(0.3520887068f)));
+  return vmlsq_n_f32(y, d, 1.72587999f);
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fasterlog2f_q(float32x4_t x) {
+  return vmlaq_n_f32(vdupq_n_f32(-126.94269504f),
+                     vcvtq_f32_u32(vreinterpretq_u32_f32(x)), 1.1920928955078125e-7f);
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fastpow2f_q(float32x4_t p) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const float32x4_t offset = vreinterpretq_f32_u32(
+      vandq_u32(vcltq_f32(p, vdupq_n_f32(0.f)), vreinterpretq_u32_f32(one)));
+  const float32x4_t clipp = vmaxq_f32(p, vdupq_n_f32(-126.f));
+  const float32x4_t z = vaddq_f32(vsubq_f32(clipp, vcvtq_f32_s32(vcvtq_s32_f32(clipp))), offset);
+  float32x4_t v = vaddq_f32(clipp, vdupq_n_f32(121.2740575f));
+  v = vmlaq_n_f32(v, bm_recip_q(vsubq_f32(vdupq_n_f32(4.84252568f), z)), 27.7280233f);
+  v = vmlsq_n_f32(v, z, 1.49012907f);
+  return vreinterpretq_f32_u32(vcvtq_u32_f32(vmulq_n_f32(v, (float)(1 << 23))));
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fasterpow2f_q(float32x4_t p) {
+  const float32x4_t clipp = vmaxq_f32(p, vdupq_n_f32(-126.f));
+  return vreinterpretq_f32_u32(vcvtq_u32_f32(
+      vmulq_n_f32(vaddq_f32(clipp, vdupq_n_f32(126.94269504f)), (float)(1 << 23))));
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_tanhpadef_q(float32x4_t x) {
+  x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-3.f)), vdupq_n_f32(3.f));
+  const float32x4_t x2 = vmulq_f32(x, x);
+  const float32x4_t n = vmulq_f32(x, vaddq_f32(x2, vdupq_n_f32(27.f)));
+  const float32x4_t d = vmlaq_n_f32(vdupq_n_f32(27.f), x2, 9.f);
+  return vmulq_f32(n, bm_recip_q(d));
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fasterdbampf_q(float32x4_t db) {
+  return bm_fasterpow2f_q(vmulq_n_f32(vmulq_n_f32(db, 0.05f), 3.30730438f));
+}
+
+/** @private */
+static inline __attribute__((always_inline))
+float32x4_t bm_fasterampdbf_q(float32x4_t amp) {
+  return vmulq_n_f32(bm_fasterlog2f_q(amp), 6.020599913279624f);
+}
+
+/** @private */
+#define BM_MAP_VEC(f, xn, yn, end)                                      \
+  for (; (xn) != (end); (xn) += 4, (yn) += 4)                           \
+    vst1q_f32((yn), f##_q(vld1q_f32(xn)))
+
+#else
+
+/** @private */
+#define BM_MAP_VEC(f, xn, yn, end)                                      \
+  for (; (xn) != (end); (xn) += 4, (yn) += 4) {                         \
+    const float x0 = (xn)[0], x1 = (xn)[1], x2 = (xn)[2], x3 = (xn)[3]; \
+    (yn)[0] = f(x0); (yn)[1] = f(x1); (yn)[2] = f(x2); (yn)[3] = f(x3); \
+  }
+
+#endif
+
+/** @private Map a kernel over a buffer, 4 values at a time then the remainder */
+#define BM_MAP(f, xn, yn, len)                                          \
+  do {                                                                  \
+    const float *end = (xn) + ((len) & ~3U);                            \
+    BM_MAP_VEC(f, xn, yn, end);                                         \
+    end += (len) & 3U;                                                  \
+    for (; (xn) != end; )                                               \
+      *((yn)++) = f(*((xn)++));                                         \
+  } while (0)
+
+/*===========================================================================*/
+/* Buffer Functions.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Buffer math
+ * @{
+ */
+
+/** Buffer-wise "fast" sine, valid for x in [-M_PI, M_PI]
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fastsinf(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fastsinf, xn, yn, len);
+}
+
+/** Buffer-wise "faster" sine, valid for x in [-M_PI, M_PI]
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fastersinf(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fastersinf, xn, yn, len);
+}
+
+/** Buffer-wise "fast" log base 2, valid for positive x
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fastlog2f(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fastlog2f, xn, yn, len);
+}
+
+/** Buffer-wise "faster" log base 2, valid for positive x
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fasterlog2f(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fasterlog2f, xn, yn, len);
+}
+
+/** Buffer-wise "fast" power of 2, valid for x in [-126, 127]
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fastpow2f(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fastpow2f, xn, yn, len);
+}
+
+/** Buffer-wise "faster" power of 2, valid for x in [-126, 127]
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fasterpow2f(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fasterpow2f, xn, yn, len);
+}
+
+/** Buffer-wise hyperbolic tangent Pade approximant, valid on full x domain
+ * @note Exact at 0 and saturating at |x| = 3, same as tier_tanhf() "faster" tier.
+ * @note Differs from fastertanhf(), e.g.: by up to 2.4e-2 on [0, 3.5].
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_tanhpadef(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_tanhpadef, xn, yn, len);
+}
+
+/** Buffer-wise "faster" dB to amplitude
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fasterdbampf(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fasterdbampf, xn, yn, len);
+}
+
+/** Buffer-wise "faster" amplitude to dB, valid for positive amplitudes
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_fasterampdbf(const float *xn, float *yn, const uint32_t len)
+{
+  BM_MAP(bm_fasterampdbf, xn, yn, len);
+}
+
+/** @} */
+
+#endif // __buffer_math_h
+
+/** @} @} */